@@ -33,6 +33,17 @@ from typing import Iterable
 # to flatten everyone else against the axis.
 BAR_CHART_EXCLUDED = frozenset({"ostringstream", "sprintf"})
 
+# Optional benchmark tracks, registered by ``src/benchmark.cc`` with names
+# of the form ``method/<track>:<param>``.
+TRACKS = ("order", "heatmap", "special", "contention", "bulk", "sizing", "ld",
+          "f128", "f16", "bf16", "g6", "g9", "g12", "inline")
+# Integer tracks, timed per value rather than per double.
+INT_TRACKS = ("u32", "u64", "i64")
+
+# Standalone tools that write ``<base>.<tool>.json`` next to the
+# dtoa-benchmark results ``<base>.json``; their charts go on the same page.
+SIDECAR_TOOLS = ("cache-pressure", "cache-contention")
+
 # Pseudo-method that does nothing; its time is the cost of the benchmark
 # loop itself (data load, indirect call, buffer write). It's surfaced as a
 # baseline footnote and a dashed reference line, not as a competing method.
@@ -108,6 +119,10 @@ def load_json(path: Path) -> list[tuple[str, int, float]]:
         if r.get("error_occurred"):
             continue
         name = r.get("run_name") or r.get("name") or ""
+        # Rows of the optional tracks (``method/<track>:<param>``) are
+        # loaded separately by ``load_track``.
+        if ":" in name:
+            continue
         sep = name.rfind("/d")
         if sep == -1:
             method, digit = name, 0
@@ -127,6 +142,79 @@ def load_json(path: Path) -> list[tuple[str, int, float]]:
     return rows
 
 
+def load_track(path: Path, track: str, field: str = "Time/double",
+               scale: float = 1e9) -> dict[str, dict[str, float]]:
+    """Read rows of an optional track, named ``method/<track>:<param>``,
+    as ``{method: {param: field * scale}}``, by default ns per double.
+    Methods keep the order in which they first appear."""
+    with path.open() as f:
+        data = json.load(f)
+
+    out: dict[str, dict[str, float]] = {}
+    prefix = f"/{track}:"
+    for r in data.get("benchmarks", []):
+        if r.get("run_type") and r["run_type"] != "iteration":
+            continue
+        if r.get("error_occurred") or field not in r:
+            continue
+        name = r.get("run_name") or r.get("name") or ""
+        sep = name.find(prefix)
+        if sep == -1:
+            continue
+        method, param = name[:sep], name[sep + len(prefix):]
+        # Drop run options appended by Google Benchmark, e.g. /min_time:0.010.
+        param = "/".join(p for p in param.split("/") if ":" not in p)
+        out.setdefault(method, {})[param] = float(r[field]) * scale
+    return out
+
+
+ALLOC_COUNTERS = ("Allocs/double", "Bytes/double", "Locale/double")
+
+
+def load_allocs(path: Path) -> dict[str, tuple[float, float, float]]:
+    """Allocation counters of the mixed benchmark, ``{method: (allocs,
+    bytes, locale lookups)}`` per double, if the file has them."""
+    with path.open() as f:
+        data = json.load(f)
+    out: dict[str, tuple[float, float, float]] = {}
+    for r in data.get("benchmarks", []):
+        name = r.get("run_name") or r.get("name") or ""
+        if "/" in name or r.get("run_type", "iteration") != "iteration":
+            continue
+        if all(c in r for c in ALLOC_COUNTERS):
+            out[name] = tuple(float(r[c]) for c in ALLOC_COUNTERS)
+    return out
+
+
+def load_context(path: Path) -> dict:
+    with path.open() as f:
+        return json.load(f).get("context", {}) or {}
+
+
+def sidecar_tool(path: Path) -> str | None:
+    """The tool that wrote ``path`` if it is ``<base>.<tool>.json``."""
+    tool = Path(path.stem).suffix[1:]
+    return tool if tool in SIDECAR_TOOLS else None
+
+
+def sidecars(src_path: Path) -> list[Path]:
+    paths = (src_path.with_name(f"{src_path.stem}.{tool}.json")
+             for tool in SIDECAR_TOOLS)
+    return [p for p in paths if p.exists()]
+
+
+def page_sources(results_dir: Path) -> list[Path]:
+    """Every ``results/*.json`` that gets its own page: sidecars are
+    rendered on the page of their base file unless it doesn't exist."""
+    out = []
+    for path in sorted(results_dir.glob("*.json")):
+        base = path.with_name(Path(path.stem).stem + ".json")
+        if sidecar_tool(path) and base.exists():
+            continue
+        out.append(path)
+    return out
+
+
 def aggregate(rows: Iterable[tuple[str, int, float]]) -> dict:
     """Bucket rows by method. Returns ``methods``/``times``/``fixed``/
     ``digits``/``mean``. Mean matches the original PHP behaviour: if a
@@ -289,7 +377,13 @@ def _nice_log_ticks(vmin: float, vmax: float) -> tuple[float, float, list[float]
 def render_line_chart(methods: list[str], digits: list[int],
                       times: dict[str, dict[int, float]],
                       colors: dict[str, str],
-                      baseline_method: str | None = None) -> str:
+                      baseline_method: str | None = None,
+                      x_title: str = "Digits",
+                      x_suffix: str = " digits",
+                      label: str = "Time vs digit count, log scale",
+                      baseline_label: str = "loop overhead") -> str:
+    """Log-scale time per method over categorical, equally spaced x
+    values. ``x_suffix`` follows the x value in the tooltip."""
     width, height = 820, 560
     margin = {"l": 64, "r": 24, "t": 16, "b": 56}
     plot_w = width - margin["l"] - margin["r"]
@@ -331,7 +425,7 @@ def render_line_chart(methods: list[str], digits: list[int],
     parts.append(
         f'<svg viewBox="0 0 {width} {height}" '
         f'class="chart line-chart" role="img" '
-        f'aria-label="Time vs digit count, log scale">'
+        f'aria-label="{_esc(label)}">'
     )
 
     # Plot background
@@ -340,7 +434,7 @@ def render_line_chart(methods: list[str], digits: list[int],
         f'width="{plot_w}" height="{plot_h}" class="plot-bg"/>'
     )
 
-    # Vertical gridlines + X tick labels (one per digit)
+    # Vertical gridlines + X tick labels (one per x value)
     for d in digits:
         x = x_of(d)
         parts.append(
@@ -349,7 +443,7 @@ def render_line_chart(methods: list[str], digits: list[int],
         )
         parts.append(
             f'<text x="{x:.2f}" y="{plot_bot + 18}" '
-            f'text-anchor="middle" class="ax">{d}</text>'
+            f'text-anchor="middle" class="ax">{_esc(str(d))}</text>'
         )
 
     # Minor horizontal gridlines (log)
@@ -386,7 +480,7 @@ def render_line_chart(methods: list[str], digits: list[int],
     # Axis titles
     parts.append(
         f'<text x="{plot_left + plot_w / 2:.2f}" y="{height - 8}" '
-        f'text-anchor="middle" class="ax-title">Digits</text>'
+        f'text-anchor="middle" class="ax-title">{_esc(x_title)}</text>'
     )
     parts.append(
         f'<text transform="translate(16 {plot_top + plot_h / 2:.2f}) '
@@ -435,7 +529,7 @@ def render_line_chart(methods: list[str], digits: list[int],
                 f'<polyline points="{bpath}" fill="none"/>'
                 f'<text x="{plot_right - 6}" y="{y_of(avg) - 6:.2f}" '
                 f'text-anchor="end" class="baseline-lbl">'
-                f'loop overhead ({avg:,.2f} ns)</text>'
+                f'{_esc(baseline_label)} ({avg:,.2f} ns)</text>'
                 f'</g>'
             )
 
@@ -462,6 +556,7 @@ def render_line_chart(methods: list[str], digits: list[int],
         "plot": {"l": plot_left, "r": plot_right,
                  "t": plot_top, "b": plot_bot},
         "series": series_meta,
+        "x_suffix": x_suffix,
     }
     # `<script>` content is raw text; escape any sequence that would close
     # the tag prematurely. HTML entity escaping must NOT be applied here.
@@ -511,6 +606,160 @@ def render_table(methods: list[str], means: dict[str, float]) -> str:
     )
 
 
+def render_alloc_table(methods: list[str],
+                       allocs: dict[str, tuple[float, float, float]]) -> str:
+    body_rows = []
+    for m in methods:
+        n, size, locale = allocs[m]
+        if n == 0 and locale == 0:
+            cells = ('<td class="num" colspan="3">'
+                     '<strong>allocation-free</strong></td>')
+        else:
+            cells = (f'<td class="num">{n:,.2f}</td>'
+                     f'<td class="num">{size:,.0f}</td>'
+                     f'<td class="num">{locale:,.2f}</td>')
+        body_rows.append(f'<tr><td class="f">{_esc(m)}</td>{cells}</tr>')
+    return (
+        '<div class="table-scroll"><table class="matrix">'
+        '<thead><tr><th scope="col">Method</th>'
+        '<th scope="col" class="num">Allocations</th>'
+        '<th scope="col" class="num">Bytes</th>'
+        '<th scope="col" class="num">Locale lookups</th></tr></thead>'
+        f'<tbody>{"".join(body_rows)}</tbody>'
+        '</table></div>'
+    )
+
+
+def render_track_table(methods: list[str], rows: dict[str, dict[str, float]],
+                       spread: bool = False) -> str:
+    """Time per double with one row per method and one column per track
+    parameter, in order of first appearance. With ``spread``, a last
+    column shows the slowest parameter over the fastest one."""
+    columns: list[str] = []
+    for m in methods:
+        for c in rows.get(m, {}):
+            if c not in columns:
+                columns.append(c)
+
+    head = "".join(f'<th scope="col" class="num">{_esc(c)}</th>'
+                   for c in columns)
+    if spread:
+        head += '<th scope="col" class="num">Spread</th>'
+    body_rows = []
+    for m in methods:
+        row = rows.get(m, {})
+        cells = "".join(
+            f'<td class="num">{row[c]:,.2f}</td>' if row.get(c, 0) > 0
+            else '<td class="num"></td>'
+            for c in columns)
+        if spread:
+            vals = [v for v in row.values() if v > 0]
+            ratio = max(vals) / min(vals) if vals else 0.0
+            cells += f'<td class="num">{ratio:.2f}x</td>'
+        body_rows.append(f'<tr><td class="f">{_esc(m)}</td>{cells}</tr>')
+    return (
+        '<div class="table-scroll"><table class="matrix">'
+        f'<thead><tr><th scope="col">Method</th>{head}</tr></thead>'
+        f'<tbody>{"".join(body_rows)}</tbody>'
+        '</table></div>'
+    )
+
+
+# Perceptually uniform color ramp (viridis) for heatmaps, fast to slow.
+HEATMAP_STOPS = ["#440154", "#3b528b", "#21918c", "#5ec962", "#fde725"]
+
+
+def _heat_color(t: float) -> str:
+    """Interpolate ``HEATMAP_STOPS`` at ``t`` in [0, 1]."""
+    t = min(max(t, 0.0), 1.0) * (len(HEATMAP_STOPS) - 1)
+    i = min(int(t), len(HEATMAP_STOPS) - 2)
+    f = t - i
+    a = HEATMAP_STOPS[i]
+    b = HEATMAP_STOPS[i + 1]
+    rgb = [round(int(a[k:k + 2], 16) * (1 - f) + int(b[k:k + 2], 16) * f)
+           for k in (1, 3, 5)]
+    return "#" + "".join(f"{c:02x}" for c in rgb)
+
+
+def parse_heatmap(cells: dict[str, float]) -> dict[tuple[int, int], float]:
+    """Map ``heatmap`` params ``<bin_exp>/d<digits>`` to (bin_exp, digits)."""
+    out: dict[tuple[int, int], float] = {}
+    for param, t in cells.items():
+        exp, _, digit = param.partition("/d")
+        try:
+            out[(int(exp), int(digit))] = t
+        except ValueError:
+            continue
+    return out
+
+
+def render_heatmap(method: str, grid: dict[tuple[int, int], float],
+                   log_lo: float, log_hi: float) -> str:
+    """One method's time per double over binary exponent bucket (x) and
+    digit count (y), on a log color scale shared by all methods."""
+    exps = sorted({e for e, _ in grid})
+    digits = sorted({d for _, d in grid})
+    cell_w, cell_h = 11, 12
+    margin = {"l": 40, "r": 8, "t": 22, "b": 30}
+    plot_w = cell_w * len(exps)
+    plot_h = cell_h * len(digits)
+    width = margin["l"] + plot_w + margin["r"]
+    height = margin["t"] + plot_h + margin["b"]
+
+    parts: list[str] = [
+        f'<svg viewBox="0 0 {width} {height}" class="chart heatmap" '
+        f'role="img" aria-label="{_esc(method)}: time by binary exponent '
+        f'and digit count">',
+        f'<text x="{margin["l"]}" y="14" class="lbl">{_esc(method)}</text>',
+    ]
+    span = (log_hi - log_lo) or 1.0
+    for (e, d), t in grid.items():
+        x = margin["l"] + exps.index(e) * cell_w
+        y = margin["t"] + (len(digits) - 1 - digits.index(d)) * cell_h
+        color = _heat_color((math.log10(t) - log_lo) / span) if t > 0 \
+            else "transparent"
+        parts.append(
+            f'<rect x="{x}" y="{y}" width="{cell_w}" height="{cell_h}" '
+            f'fill="{color}"><title>2^{e}, {d} digits: {t:,.2f} ns'
+            f'</title></rect>'
+        )
+    for i, e in enumerate(exps):
+        if i % 8 == 0:
+            x = margin["l"] + i * cell_w
+            parts.append(
+                f'<text x="{x}" y="{margin["t"] + plot_h + 14}" '
+                f'class="ax">2^{e}</text>'
+            )
+    for i, d in enumerate(digits):
+        if d % 4 == 1:
+            y = margin["t"] + (len(digits) - 1 - i) * cell_h + cell_h / 2
+            parts.append(
+                f'<text x="{margin["l"] - 6}" y="{y:.1f}" text-anchor="end" '
+                f'dominant-baseline="middle" class="ax">d{d}</text>'
+            )
+    parts.append('</svg>')
+    return "".join(parts)
+
+
+def render_heatmaps(methods: list[str],
+                    cells: dict[str, dict[str, float]]) -> str:
+    grids = {m: parse_heatmap(cells[m]) for m in methods}
+    vals = [t for g in grids.values() for t in g.values() if t > 0]
+    if not vals:
+        return ""
+    log_lo, log_hi = math.log10(min(vals)), math.log10(max(vals))
+    scale = "".join(
+        f'<span class="heat-stop" style="background:{_heat_color(i / 8)}">'
+        '</span>' for i in range(9))
+    return (
+        '<div class="heat-scale">'
+        f'<span>{10 ** log_lo:,.2f} ns</span>{scale}'
+        f'<span>{10 ** log_hi:,.2f} ns</span></div>'
+        + "".join(f'<div class="chart-wrap">{render_heatmap(m, grids[m], log_lo, log_hi)}</div>'
+                  for m in methods if grids[m])
+    )
+
+
 # ---------------------------------------------------------------------------
 # Page assembly
 # ---------------------------------------------------------------------------
@@ -730,6 +979,40 @@ table.results tbody tr:focus-visible {
   outline: 2px solid var(--accent);
   outline-offset: -2px;
 }
+.table-scroll { overflow-x: auto; }
+table.matrix {
+  width: 100%;
+  border-collapse: collapse;
+  font-variant-numeric: tabular-nums;
+  font-size: 13px;
+}
+table.matrix th,
+table.matrix td {
+  padding: 6px 8px;
+  border-bottom: 1px solid var(--border);
+  text-align: left;
+  white-space: nowrap;
+}
+table.matrix th {
+  font-weight: 600;
+  color: var(--fg-muted);
+  font-size: 11px;
+  text-transform: uppercase;
+  letter-spacing: 0.03em;
+}
+table.matrix td.num,
+table.matrix th.num { text-align: right; }
+.heat-scale {
+  display: flex;
+  align-items: center;
+  gap: 0;
+  font-size: 12px;
+  color: var(--fg-muted);
+  margin-bottom: 8px;
+}
+.heat-scale span:first-child { margin-right: 8px; }
+.heat-scale span:last-child { margin-left: 8px; }
+.heat-scale .heat-stop { width: 24px; height: 10px; }
 .chart-wrap {
   position: relative;
 }
@@ -1101,7 +1384,8 @@ PAGE_JS = r"""
 
       // Render tooltip content + position.
       tooltip.innerHTML =
-        '<div class="d">' + best.point.d + ' digits</div>' +
+        '<div class="d">' + escapeHtml(String(best.point.d)) +
+        escapeHtml(meta.x_suffix) + '</div>' +
         '<div class="r"><span class="sw" style="background:' +
         best.series.color + '"></span><span class="f">' +
         escapeHtml(best.series.method) + '</span>:&nbsp;<span class="v">' +
@@ -1345,7 +1629,7 @@ def collect_index_entries(results_dir: Path) -> list[dict]:
     """Read every ``results/*.json`` and build a metadata + ranking summary
     suitable for rendering the listing page."""
     entries: list[dict] = []
-    for json_path in sorted(results_dir.glob("*.json")):
+    for json_path in page_sources(results_dir):
         try:
             with json_path.open() as f:
                 data = json.load(f)
@@ -1492,7 +1776,87 @@ def render_index_page(entries: list[dict]) -> str:
 """
 
 
-def render_results(bucket: dict) -> str:
+def _format_kb(kb: int) -> str:
+    return f"{kb // 1024}MB" if kb >= 1024 and kb % 1024 == 0 else f"{kb}KB"
+
+
+def render_eviction(rows: dict[str, dict[str, float]],
+                    baseline_ns: float) -> list[str]:
+    """Line chart of cache-pressure rows, ``method/eviction:<calls>``: the
+    time to reload a 16KB working set after that many conversions."""
+    if not rows:
+        return []
+    methods = list(rows)
+    colors = _palette(methods)
+    calls = sorted({int(c) for r in rows.values() for c in r if c.isdigit()})
+    times = {m: {str(c): r[str(c)] for c in calls if str(c) in r}
+             for m, r in rows.items()}
+    baseline = None
+    if baseline_ns > 0:
+        baseline = "reload baseline"
+        times[baseline] = {str(c): baseline_ns for c in calls}
+    return [
+        '<div class="card">',
+        '<h3>L1 eviction curve (log scale)</h3>',
+        render_line_chart(methods, [str(c) for c in calls], times, colors,
+                          baseline_method=baseline,
+                          x_title="dtoa calls before reload",
+                          x_suffix=" calls",
+                          label="Working set reload time vs dtoa calls, "
+                                "log scale",
+                          baseline_label="reload without dtoa calls"),
+        render_legend(methods, colors),
+        '<p class="hint">Time to reload a working set resident in L1d after '
+        'N conversions, measured by <code>cache-pressure</code>. The '
+        'further a method\'s curve rises above the baseline, the more '
+        'lines its code and tables evicted.</p>',
+        '</div>',
+    ]
+
+
+def render_contention(rows: dict[str, dict[str, float]]) -> list[str]:
+    """One line chart per competitor access pattern from cache-contention
+    rows, ``method/contention:<pattern>/<kb>KB``, with the competitor
+    working set on the x axis."""
+    curves: dict[str, dict[str, dict[int, float]]] = {}
+    for method, params in rows.items():
+        for param, ns in params.items():
+            pattern, _, size = param.partition("/")
+            if not size.endswith("KB") or not size[:-2].isdigit():
+                continue
+            curves.setdefault(pattern, {}).setdefault(
+                method, {})[int(size[:-2])] = ns
+
+    parts: list[str] = []
+    for pattern, times in curves.items():
+        methods = list(times)
+        colors = _palette(methods)
+        sizes = sorted({kb for t in times.values() for kb in t})
+        labels = [_format_kb(kb) for kb in sizes]
+        by_label = {m: {_format_kb(kb): ns for kb, ns in t.items()}
+                    for m, t in times.items()}
+        parts += [
+            '<div class="card">',
+            f'<h3>Slowdown under cache contention: {_esc(pattern)} '
+            'competitor (log scale)</h3>',
+            render_line_chart(methods, labels, by_label, colors,
+                              x_title="Competitor working set",
+                              x_suffix=" competitor",
+                              label=f"Time vs {pattern} competitor working "
+                                    "set, log scale"),
+            render_legend(methods, colors),
+            '<p class="hint">ns per double with the competitor touching '
+            'the given working set between batches of 16 conversions. '
+            'Steps at the L1d, L2 and LLC sizes show how much of the '
+            'method\'s tables and code it has to refetch.</p>',
+            '</div>',
+        ]
+    return parts
+
+
+def render_results(bucket: dict, tracks: dict,
+                   reload_baseline_ns: float = 0.0,
+                   allocs: dict | None = None) -> str:
     methods = bucket["methods"]
     means = bucket["mean"]
     digits = bucket["digits"]
@@ -1505,39 +1869,44 @@ def render_results(bucket: dict) -> str:
     display_methods = [m for m in methods if m != BASELINE_METHOD]
     colors = _palette(methods)
 
-    parts = [
-        '<div class="card">',
-        '<h3>Time per double (lower is better)</h3>',
-        render_table(display_methods, means),
-        '<div class="hint-row">'
-        '<p class="hint">Click any row to use it as the speedup '
-        'baseline.</p>'
-        '<button type="button" class="copy-md">Copy as Markdown</button>'
-        '</div>',
-    ]
-    if has_baseline:
-        parts.append(
-            f'<p class="hint">Times include a fixed loop-overhead floor of '
-            f'<strong>{means[BASELINE_METHOD]:,.2f} ns</strong> '
-            f'(measured with a no-op stand-in for <code>dtoa</code>).</p>'
-        )
-
-    bar_methods = [m for m in display_methods if m not in BAR_CHART_EXCLUDED]
-    if bar_methods:
-        excluded_present = sorted(BAR_CHART_EXCLUDED & set(display_methods))
-        if excluded_present:
-            names = " and ".join(f"<code>{_esc(n)}</code>"
-                                 for n in excluded_present)
-            hint = (f'<p class="hint">{names} omitted; they are an order '
-                    f'of magnitude slower than the rest.</p>')
-        else:
-            hint = '<p class="hint">All measured methods shown.</p>'
+    # Tracks-only results (e.g. from cache-contention) have no summary.
+    parts: list[str] = []
+    if display_methods:
         parts += [
-            '<div class="card-divider"></div>',
-            render_bar_chart(display_methods, means, colors),
-            hint,
+            '<div class="card">',
+            '<h3>Time per double (lower is better)</h3>',
+            render_table(display_methods, means),
+            '<div class="hint-row">'
+            '<p class="hint">Click any row to use it as the speedup '
+            'baseline.</p>'
+            '<button type="button" class="copy-md">Copy as Markdown</button>'
+            '</div>',
         ]
-    parts.append('</div>')
+        if has_baseline:
+            parts.append(
+                f'<p class="hint">Times include a fixed loop-overhead floor of '
+                f'<strong>{means[BASELINE_METHOD]:,.2f} ns</strong> '
+                f'(measured with a no-op stand-in for <code>dtoa</code>).</p>'
+            )
+
+        bar_methods = [m for m in display_methods
+                       if m not in BAR_CHART_EXCLUDED]
+        if bar_methods:
+            excluded_present = sorted(BAR_CHART_EXCLUDED &
+                                      set(display_methods))
+            if excluded_present:
+                names = " and ".join(f"<code>{_esc(n)}</code>"
+                                     for n in excluded_present)
+                hint = (f'<p class="hint">{names} omitted; they are an order '
+                        f'of magnitude slower than the rest.</p>')
+            else:
+                hint = '<p class="hint">All measured methods shown.</p>'
+            parts += [
+                '<div class="card-divider"></div>',
+                render_bar_chart(display_methods, means, colors),
+                hint,
+            ]
+        parts.append('</div>')
 
     if digits and times:
         parts += [
@@ -1552,12 +1921,286 @@ def render_results(bucket: dict) -> str:
             '</div>',
         ]
 
+    allocs = allocs or {}
+    alloc_methods = [m for m in display_methods if m in allocs]
+    if alloc_methods:
+        parts += [
+            '<div class="card">',
+            '<h3>Allocations and locale lookups per double</h3>',
+            render_alloc_table(alloc_methods, allocs),
+            '<p class="hint">Counted in an untimed pass over the mixed '
+            'benchmark by interposing <code>malloc</code>, '
+            '<code>operator new</code> and the C locale API.</p>',
+            '</div>',
+        ]
+
+    # Cache tool charts from sidecar files, next to the throughput charts.
+    parts += render_eviction(tracks.get("eviction", {}), reload_baseline_ns)
+    parts += render_contention(tracks.get("contention", {}))
+
+    by_mean = sorted(display_methods, key=lambda m: means.get(m, 0.0))
+    orders = tracks.get("order", {})
+    order_methods = [m for m in by_mean if m in orders]
+    if order_methods:
+        # The headline mixed benchmark is the shuffled ordering.
+        rows = {m: {"shuffled": means.get(m, 0.0), **orders[m]}
+                for m in order_methods}
+        parts += [
+            '<div class="card">',
+            '<h3>Input ordering sensitivity (ns per double)</h3>',
+            render_track_table(order_methods, rows, spread=True),
+            '<p class="hint">The same values in different orders. '
+            '<strong>Spread</strong> is the slowest ordering divided by the '
+            'fastest one; branchy methods depend more on the order than '
+            'branchless ones.</p>',
+            '</div>',
+        ]
+
+    specials = tracks.get("special", {})
+    special_methods = [m for m in by_mean if m in specials]
+    if special_methods:
+        rows = {m: {**specials[m], "mixed": means.get(m, 0.0)}
+                for m in special_methods}
+        parts += [
+            '<div class="card">',
+            '<h3>Special values and edge cases (ns per double)</h3>',
+            render_track_table(special_methods, rows),
+            '<p class="hint">Pools of a single edge-case class with random '
+            'signs, and mixes such as <code>zero30</code> (30% zeros, the '
+            'rest from the mixed pool). <strong>mixed</strong> is the '
+            'headline mixed benchmark for reference.</p>',
+            '</div>',
+        ]
+
+    bulk = tracks.get("bulk", {})
+    bulk_methods = [m for m in by_mean if m in bulk]
+    if bulk_methods:
+        bulk_bytes = tracks.get("bulk_bytes", {})
+        rows = {m: {"stack": means.get(m, 0.0), **bulk[m],
+                    "bytes/double": max(bulk_bytes.get(m, {}).values(),
+                                        default=0.0)}
+                for m in bulk_methods}
+        parts += [
+            '<div class="card">',
+            '<h3>Bulk output into an arena (ns per double)</h3>',
+            render_track_table(bulk_methods, rows),
+            '<p class="hint">The mixed pool appended to an output arena '
+            'that is reset every iteration, as a serializer writes into a '
+            'fresh buffer: <strong>append</strong> with 4K pages, '
+            '<strong>nt</strong> through an L1 staging buffer copied with '
+            'non-temporal stores, <strong>huge</strong> with huge pages, '
+            '<strong>bounce</strong> through a scratch buffer and '
+            '<code>memcpy</code>, <strong>packed</strong> directly while '
+            'the declared maximum bytes written fit. '
+            '<strong>stack</strong> is the headline mixed benchmark, which '
+            'overwrites one stack buffer. <strong>bytes/double</strong> is '
+            'the average output length.</p>',
+            '</div>',
+        ]
+
+    sizing = tracks.get("sizing", {})
+    sizing_methods = [m for m in by_mean if m in sizing]
+    if sizing_methods:
+        rows = {m: {"stack": means.get(m, 0.0), **sizing[m]}
+                for m in sizing_methods}
+        parts += [
+            '<div class="card">',
+            '<h3>Sizing a column (ns per double)</h3>',
+            render_track_table(sizing_methods, rows),
+            '<p class="hint">The mixed pool written as a newline-separated '
+            'column into a new buffer: <strong>two-pass</strong> allocates '
+            'the exact size computed by the method\'s length function first, '
+            '<strong>realloc</strong> doubles the buffer whenever it is '
+            'full, and <strong>length</strong> is the length pass alone. '
+            '<strong>stack</strong> is the headline mixed benchmark.</p>',
+            '</div>',
+        ]
+
+    # Direct calls: the mixed pool through dtoa_fun and with the loop
+    # instantiated per method, including the null baseline.
+    inlined = tracks.get("inline", {})
+    inline_methods = sorted((m for m in inlined if "mixed" in inlined[m]),
+                            key=lambda m: means.get(m, 0.0))
+    if inline_methods:
+        rows = {m: {"indirect": means.get(m, 0.0),
+                    "inline": inlined[m]["mixed"]}
+                for m in inline_methods}
+        parts += [
+            '<div class="card">',
+            '<h3>Inlined vs. indirect calls (ns per double)</h3>',
+            render_track_table(inline_methods, rows),
+            '<p class="hint"><strong>indirect</strong> is the headline mixed '
+            'benchmark, which calls every method through a function '
+            'pointer. <strong>inline</strong> runs the same loop '
+            'instantiated for the method, so the conversion can be inlined '
+            'as in application code. The <strong>null</strong> row is the '
+            'loop overhead included in every time.</p>',
+            '</div>',
+        ]
+
+    # Plug-ins loaded with --plugin, next to the in-tree method of that name.
+    plugin_methods = [m for m in by_mean
+                      if "@" in m and m.split("@")[0] in means]
+    if plugin_methods:
+        rows = {m: {"in-tree": means[m.split("@")[0]], "plug-in": means[m]}
+                for m in plugin_methods}
+        parts += [
+            '<div class="card">',
+            '<h3>Plug-ins (ns per double)</h3>',
+            render_track_table(plugin_methods, rows),
+            '<p class="hint">Methods loaded from shared objects with '
+            '<code>--plugin</code>, named <code>method@plug-in</code>, '
+            'against the statically linked method of the same name. The '
+            'difference is the cost of position-independent code and of '
+            'PLT calls inside the plug-in; build IDs are in the JSON '
+            'context.</p>',
+            '</div>',
+        ]
+
+    # Extended precision: digit sweeps of their own, with parameters d<N>.
+    for track, title, max_digits in (("ld", "long double", 21),
+                                     ("f128", "binary128", 36)):
+        sweep = {m: {int(p[1:]): t for p, t in row.items()
+                     if p[1:].isdigit()}
+                 for m, row in tracks.get(track, {}).items()}
+        sweep_methods = sorted(sweep, key=lambda m: sum(sweep[m].values()))
+        if not sweep_methods:
+            continue
+        sweep_colors = _palette(sweep_methods)
+        parts += [
+            '<div class="card">',
+            f'<h3>{title}: time vs. digit count (log scale)</h3>',
+            render_line_chart(sweep_methods, list(range(1, max_digits + 1)),
+                              sweep, sweep_colors,
+                              label=f"{title} time vs digit count, log scale"),
+            render_legend(sweep_methods, sweep_colors),
+            f'<p class="hint">Values with 1 to {max_digits} significant '
+            f'digits, verified by a round trip through '
+            f'<code>{"strtold" if track == "ld" else "strtoflt128"}</code>.'
+            f'</p>',
+            '</div>',
+        ]
+
+    # 16-bit formats: every finite value, a normal sample and a column.
+    for track, title in (("f16", "binary16"), ("bf16", "bfloat16")):
+        half = tracks.get(track, {})
+        half_methods = sorted(half, key=lambda m: half[m].get("all", 0.0))
+        if not half_methods:
+            continue
+        parts += [
+            '<div class="card">',
+            f'<h3>{title} (ns per value)</h3>',
+            render_track_table(half_methods, half),
+            '<p class="hint"><strong>all</strong> is every finite value in '
+            'random order, <strong>normal</strong> N(0, 1) samples rounded '
+            f'to {title}, <strong>batch</strong> the normal samples written '
+            'as a newline-separated column. All values are verified by a '
+            'round trip.</p>',
+            '</div>',
+        ]
+
+    # Bounded shortest: the mixed pool at each precision.
+    bounded: dict[str, dict[str, float]] = {}
+    for track in ("g6", "g9", "g12"):
+        for m, row in tracks.get(track, {}).items():
+            if "mixed" in row:
+                bounded.setdefault(m, {})[f"%.{track[1:]}g"] = row["mixed"]
+    bounded_methods = sorted(bounded, key=lambda m: sum(bounded[m].values()))
+    if bounded_methods:
+        parts += [
+            '<div class="card">',
+            '<h3>Shortest within N digits (ns per double)</h3>',
+            render_track_table(bounded_methods, bounded),
+            '<p class="hint">The mixed pool with at most 6, 9 or 12 '
+            'significant digits: the shortest representation, rounded '
+            'where it is longer. The output is verified to be identical to '
+            '<code>printf("%.Ng")</code>.</p>',
+            '</div>',
+        ]
+
+    # Integers: the mixed datasets side by side, then a digit sweep per type.
+    ints: dict[str, dict[str, float]] = {}
+    for track, title in (("u32", "uint32"), ("u64", "uint64"),
+                         ("i64", "int64")):
+        for m, row in tracks.get(track, {}).items():
+            if "mixed" in row:
+                ints.setdefault(m, {})[title] = row["mixed"]
+    int_methods = sorted(ints, key=lambda m: sum(ints[m].values()))
+    if int_methods:
+        parts += [
+            '<div class="card">',
+            '<h3>Integers (ns per value)</h3>',
+            render_track_table(int_methods, ints),
+            '<p class="hint">Values with a uniformly distributed number of '
+            'digits, half of them negative for <strong>int64</strong>. The '
+            'output is verified to be identical to '
+            '<code>std::to_chars</code>.</p>',
+            '</div>',
+        ]
+    for track, title, max_digits in (("u32", "uint32", 10),
+                                     ("u64", "uint64", 20),
+                                     ("i64", "int64", 19)):
+        sweep = {m: {int(p[1:]): t for p, t in row.items()
+                     if p[1:].isdigit()}
+                 for m, row in tracks.get(track, {}).items()}
+        sweep_methods = sorted(sweep, key=lambda m: sum(sweep[m].values()))
+        if not sweep_methods:
+            continue
+        sweep_colors = _palette(sweep_methods)
+        parts += [
+            '<div class="card">',
+            f'<h3>{title}: time vs. digit count (log scale)</h3>',
+            render_line_chart(sweep_methods, list(range(1, max_digits + 1)),
+                              sweep, sweep_colors,
+                              label=f"{title} time vs digit count, log scale"),
+            render_legend(sweep_methods, sweep_colors),
+            '</div>',
+        ]
+
+    heatmap = tracks.get("heatmap", {})
+    heatmap_methods = [m for m in display_methods if m in heatmap]
+    if heatmap_methods:
+        parts += [
+            '<div class="card">',
+            '<h3>Time by binary exponent and digit count (log color scale)'
+            '</h3>',
+            render_heatmaps(heatmap_methods, heatmap),
+            '<p class="hint">Columns are binary exponent buckets from '
+            '2<sup>-1074</sup> to 2<sup>1023</sup>, rows are significant '
+            'digits. Bright cells are slow regions; hover a cell for its '
+            'time.</p>',
+            '</div>',
+        ]
+
     return "".join(parts)
 
 
 def render_page(src_path: Path) -> str:
     name = src_path.stem
-    body_html = render_results(aggregate(load_json(src_path)))
+    tracks: dict[str, dict] = {}
+    baseline_ns = 0.0
+    for path in [src_path, *sidecars(src_path)]:
+        for t in TRACKS:
+            for method, row in load_track(path, t).items():
+                tracks.setdefault(t, {}).setdefault(method, {}).update(row)
+        for t in INT_TRACKS:
+            for method, row in load_track(path, t, "Time/value").items():
+                tracks.setdefault(t, {}).setdefault(method, {}).update(row)
+        # Reload times of cache-pressure, in ns per working-set reload.
+        for method, row in load_track(path, "eviction", "real_time",
+                                      1.0).items():
+            tracks.setdefault("eviction", {}).setdefault(
+                method, {}).update(row)
+        # Output bytes per double of the bulk track.
+        for method, row in load_track(path, "bulk", "Output/double",
+                                      1.0).items():
+            tracks.setdefault("bulk_bytes", {}).setdefault(
+                method, {}).update(row)
+        baseline_ns = float(load_context(path).get("reload_baseline_ns",
+                                                   baseline_ns))
+    body_html = render_results(aggregate(load_json(src_path)), tracks,
+                               reload_baseline_ns=baseline_ns,
+                               allocs=load_allocs(src_path))
 
     return f"""<!doctype html>
 <html lang="en">
@@ -1601,11 +2244,13 @@ def process(src_path: Path) -> Path:
 
 
 def is_stale(src_path: Path) -> bool:
-    """True if the matching .html is missing or older than the source."""
+    """True if the matching .html is missing or older than the source or
+    one of its sidecars."""
     out = src_path.with_suffix(".html")
     if not out.exists():
         return True
-    return src_path.stat().st_mtime > out.stat().st_mtime
+    return any(p.stat().st_mtime > out.stat().st_mtime
+               for p in [src_path, *sidecars(src_path)])
 
 
 def main(argv: list[str]) -> int:
@@ -1628,7 +2273,7 @@ def main(argv: list[str]) -> int:
     if args.index_only:
         targets: list[Path] = []
     elif args.all:
-        targets = sorted(results_dir.glob("*.json"))
+        targets = page_sources(results_dir)
     else:
         targets = list(args.inputs)
 
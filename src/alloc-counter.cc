@@ -0,0 +1,176 @@
+#include "alloc-counter.h"
+
+#include <errno.h>   // ENOMEM
+#include <stdlib.h>  // malloc, free
+
+#include <new>  // std::bad_alloc, std::nothrow_t
+
+#ifdef __GLIBC__
+#  include <dlfcn.h>  // dlsym, RTLD_NEXT
+#  include <langinfo.h>
+#  include <locale.h>
+#endif
+
+namespace {
+
+// Per thread, so that only the thread between start_alloc_counting and
+// stop_alloc_counting is counted, not e.g. dataset generation threads. The
+// executable's TLS is static, so reading it doesn't allocate.
+thread_local bool counting = false;
+alloc_stats stats;
+
+inline void count_allocation(size_t size) {
+  if (!counting) return;
+  ++stats.allocations;
+  stats.bytes += size;
+}
+
+#ifdef __GLIBC__
+// malloc is interposed, so operator new is counted there.
+constexpr bool count_new = false;
+
+inline void count_locale_lookup() {
+  if (counting) ++stats.locale_lookups;
+}
+
+template <typename F> auto next_function(const char* name) -> F* {
+  return reinterpret_cast<F*>(dlsym(RTLD_NEXT, name));
+}
+#else
+constexpr bool count_new = true;
+#endif
+
+}  // namespace
+
+void start_alloc_counting() {
+  stats = {};
+  counting = true;
+}
+
+auto stop_alloc_counting() -> alloc_stats {
+  counting = false;
+  return stats;
+}
+
+// Replaceable allocation functions. The array and aligned forms of the
+// standard library forward to these or to malloc/aligned_alloc.
+void* operator new(size_t size) {
+  if (count_new) count_allocation(size);
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  if (count_new) count_allocation(size);
+  return malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#ifdef __GLIBC__
+// glibc supports replacing malloc in the executable; the __libc_* entry
+// points are the original allocator.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* p);
+
+void* malloc(size_t size) noexcept {
+  count_allocation(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) noexcept {
+  count_allocation(n * size);
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* p, size_t size) noexcept {
+  count_allocation(size);
+  return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+  count_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  count_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) noexcept {
+  count_allocation(size);
+  void* p = __libc_memalign(alignment, size);
+  if (!p) return ENOMEM;
+  *result = p;
+  return 0;
+}
+
+void free(void* p) noexcept { __libc_free(p); }
+
+// Locale lookups. libstdc++ calls the __-prefixed aliases, e.g. __uselocale
+// in std::__convert_from_v, which is behind num_put for floating point.
+// glibc's printf reads the current locale internally and isn't counted.
+locale_t __uselocale(locale_t loc);
+locale_t __newlocale(int mask, const char* name, locale_t base);
+locale_t __duplocale(locale_t loc);
+char* __nl_langinfo_l(nl_item item, locale_t loc);
+
+locale_t __uselocale(locale_t loc) {
+  static auto next = next_function<locale_t(locale_t)>("__uselocale");
+  count_locale_lookup();
+  return next(loc);
+}
+
+locale_t uselocale(locale_t loc) noexcept { return __uselocale(loc); }
+
+locale_t __newlocale(int mask, const char* name, locale_t base) {
+  static auto next =
+      next_function<locale_t(int, const char*, locale_t)>("__newlocale");
+  count_locale_lookup();
+  return next(mask, name, base);
+}
+
+locale_t newlocale(int mask, const char* name, locale_t base) noexcept {
+  return __newlocale(mask, name, base);
+}
+
+locale_t __duplocale(locale_t loc) {
+  static auto next = next_function<locale_t(locale_t)>("__duplocale");
+  count_locale_lookup();
+  return next(loc);
+}
+
+locale_t duplocale(locale_t loc) noexcept { return __duplocale(loc); }
+
+char* __nl_langinfo_l(nl_item item, locale_t loc) {
+  static auto next =
+      next_function<char*(nl_item, locale_t)>("__nl_langinfo_l");
+  count_locale_lookup();
+  return next(item, loc);
+}
+
+char* nl_langinfo_l(nl_item item, locale_t loc) noexcept {
+  return __nl_langinfo_l(item, loc);
+}
+
+char* nl_langinfo(nl_item item) noexcept {
+  static auto next = next_function<char*(nl_item)>("nl_langinfo");
+  count_locale_lookup();
+  return next(item);
+}
+
+struct lconv* localeconv() noexcept {
+  static auto next = next_function<struct lconv*()>("localeconv");
+  count_locale_lookup();
+  return next();
+}
+}  // extern "C"
+#endif  // __GLIBC__
@@ -0,0 +1,24 @@
+// Allocation and locale accounting for dtoa-benchmark.
+//
+// alloc-counter.cc replaces operator new/delete and, with glibc, interposes
+// malloc and friends as well as the C locale API (uselocale, newlocale,
+// localeconv, nl_langinfo, ...) that e.g. libstdc++'s num_put goes through.
+// Counting is off except between start_alloc_counting and
+// stop_alloc_counting, and only counts the thread that called them; only one
+// thread may count at a time.
+
+#ifndef ALLOC_COUNTER_H_
+#define ALLOC_COUNTER_H_
+
+#include <stddef.h>  // size_t
+
+struct alloc_stats {
+  size_t allocations = 0;
+  size_t bytes = 0;
+  size_t locale_lookups = 0;
+};
+
+void start_alloc_counting();
+auto stop_alloc_counting() -> alloc_stats;
+
+#endif  // ALLOC_COUNTER_H_
@@ -0,0 +1,240 @@
+// Integer formatting with the BCD kernels of zmij (zmij/zmij.cc): a value
+// below 10**8 is split into two 4-digit limbs and a value below 10**16 into
+// four, and the limbs are converted to one digit per byte in parallel, with
+// SSE2/SSE4.1 or NEON if available and with the SWAR fallback otherwise.
+// Leading zeros are then dropped by a shift instead of a digit count.
+//
+// The writers store whole 8- or 16-byte blocks, at most 24 bytes from the
+// output pointer on for a signed 64-bit value.
+
+#ifndef BCD_ITOA_H_
+#define BCD_ITOA_H_
+
+#include <stdint.h>  // uint64_t
+#include <string.h>  // memcpy, memmove
+
+#include <bit>  // std::countr_zero, std::endian
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#  include <arm_neon.h>
+#  define BCD_ITOA_USE_NEON 1
+#elif defined(__SSE2__) || defined(_M_AMD64)
+#  include <immintrin.h>
+#  define BCD_ITOA_USE_SSE 1
+#endif
+
+namespace bcd_itoa {
+
+constexpr int div10k_exp = 40;
+constexpr uint32_t div10k_sig = uint32_t((1ull << div10k_exp) / 10000 + 1);
+constexpr uint32_t neg10k = uint32_t((1ull << 32) - 10000);
+
+constexpr int div100_exp = 19;
+constexpr uint32_t div100_sig = (1 << div100_exp) / 100 + 1;
+constexpr uint32_t neg100 = (1 << 16) - 100;
+
+constexpr int div10_exp = 10;
+constexpr uint32_t div10_sig = (1 << div10_exp) / 10 + 1;
+constexpr uint32_t neg10 = (1 << 8) - 10;
+
+constexpr uint64_t zeros = 0x0101010101010101u * '0';
+
+constexpr bool is_big_endian = std::endian::native == std::endian::big;
+
+inline auto bswap64(uint64_t x) noexcept -> uint64_t {
+#if defined(__GNUC__)
+  return __builtin_bswap64(x);
+#else
+  return ((x & 0xff00000000000000) >> 56) | ((x & 0x00ff000000000000) >> 40) |
+         ((x & 0x0000ff0000000000) >> 24) | ((x & 0x000000ff00000000) >> +8) |
+         ((x & 0x00000000ff000000) << +8) | ((x & 0x0000000000ff0000) << 24) |
+         ((x & 0x000000000000ff00) << 40) | ((x & 0x00000000000000ff) << 56);
+#endif
+}
+
+#if BCD_ITOA_USE_NEON
+
+// Converts four numbers < 10000, one in each 32-bit lane, to BCD digits in
+// reverse order within each lane.
+inline auto to_bcd_4x4(int32x4_t efgh_abcd_mnop_ijkl) noexcept -> uint8x16_t {
+  int32x4_t ef_ab_mn_ij =
+      vqdmulhq_n_s32(efgh_abcd_mnop_ijkl, int32_t(div100_sig << 12));
+  int16x8_t gh_ef_cd_ab_op_mn_kl_ij = vreinterpretq_s16_s32(
+      vmlaq_n_s32(efgh_abcd_mnop_ijkl, ef_ab_mn_ij, int32_t(neg100)));
+  int16x8_t high_10s = vqdmulhq_n_s16(gh_ef_cd_ab_op_mn_kl_ij, 0xce0);
+  return vreinterpretq_u8_s16(
+      vmlaq_n_s16(gh_ef_cd_ab_op_mn_kl_ij, high_10s, int16_t(neg10)));
+}
+
+#elif BCD_ITOA_USE_SSE
+
+// Converts four numbers < 10000, one in each 32-bit lane, to BCD digits.
+// Digits in each 32-bit lane will be in order for SSE2, reversed for SSE4.1.
+inline auto to_bcd_4x4(__m128i y) noexcept -> __m128i {
+  const __m128i div100 = _mm_set1_epi32(div100_sig);
+  const __m128i div10 = _mm_set1_epi16((1 << 16) / 10 + 1);
+#  ifdef __SSE4_1__
+  const __m128i z = _mm_add_epi64(
+      y, _mm_mullo_epi32(_mm_set1_epi32(neg100),
+                         _mm_srli_epi32(_mm_mulhi_epu16(y, div100), 3)));
+  return _mm_add_epi16(
+      z, _mm_mullo_epi16(_mm_set1_epi16(neg10), _mm_mulhi_epu16(z, div10)));
+#  else
+  __m128i y_div_100 = _mm_srli_epi16(_mm_mulhi_epu16(y, div100), 3);
+  __m128i y_mod_100 =
+      _mm_sub_epi16(y, _mm_mullo_epi16(y_div_100, _mm_set1_epi32(100)));
+  __m128i z = _mm_or_si128(_mm_slli_epi32(y_mod_100, 16), y_div_100);
+  return _mm_sub_epi16(_mm_slli_epi16(z, 8),
+                       _mm_mullo_epi16(_mm_set1_epi16(10 * (1 << 8) - 1),
+                                       _mm_mulhi_epu16(z, div10)));
+#  endif  // __SSE4_1__
+}
+
+#endif  // BCD_ITOA_USE_SSE
+
+// Returns the 8 digits of abcdefgh < 10**8 as BCD, one digit per byte with
+// the first digit at the lowest address.
+inline auto to_bcd8(uint64_t abcdefgh) noexcept -> uint64_t {
+#if BCD_ITOA_USE_NEON
+  uint64_t abcd_efgh =
+      abcdefgh + neg10k * ((abcdefgh * div10k_sig) >> div10k_exp);
+  int32x4_t input = vcombine_s32(
+      vreinterpret_s32_u64(vcreate_u64(abcd_efgh)), vdup_n_s32(0));
+  uint8x8_t digits = vget_low_u8(to_bcd_4x4(input));
+  return vget_lane_u64(vreinterpret_u64_u8(vrev64_u8(digits)), 0);
+#elif BCD_ITOA_USE_SSE
+#  ifdef __SSE4_1__
+  uint64_t abcd_efgh =
+      abcdefgh + neg10k * ((abcdefgh * div10k_sig) >> div10k_exp);
+#  else
+  // The limbs are swapped so that the SSE2 result is in order.
+  uint64_t abcd_efgh =
+      (abcdefgh << 32) -
+      uint64_t((10000ull << 32) - 1) * ((abcdefgh * div10k_sig) >> div10k_exp);
+#  endif
+  uint64_t bcd = 0;
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&bcd),
+                   to_bcd_4x4(_mm_set_epi64x(0, int64_t(abcd_efgh))));
+#  ifdef __SSE4_1__
+  bcd = bswap64(bcd);
+#  endif
+  return bcd;
+#else
+  // Three steps BCD. Base 10000 -> base 100 -> base 10, see zmij's to_bcd8.
+  uint64_t abcd_efgh =
+      abcdefgh + neg10k * ((abcdefgh * div10k_sig) >> div10k_exp);
+  uint64_t ab_cd_ef_gh =
+      abcd_efgh +
+      neg100 * (((abcd_efgh * div100_sig) >> div100_exp) & 0x7f0000007f);
+  uint64_t a_b_c_d_e_f_g_h =
+      ab_cd_ef_gh +
+      neg10 * (((ab_cd_ef_gh * div10_sig) >> div10_exp) & 0xf000f000f000f);
+  return is_big_endian ? a_b_c_d_e_f_g_h : bswap64(a_b_c_d_e_f_g_h);
+#endif
+}
+
+// Writes the 16 digits of value < 10**16, including leading zeros, and
+// returns the number of leading zeros, at most 15.
+inline auto write_digits16(uint64_t value, char* buffer) noexcept -> int {
+  uint64_t hi = value / 100'000'000;
+  uint64_t lo = value % 100'000'000;
+#if BCD_ITOA_USE_NEON
+  uint64x1_t lo_hi_64 = {lo << 32 | hi};
+  int32x2_t hi_lo = vreinterpret_s32_u64(lo_hi_64);
+  int32x2_t abcd_ijkl = vreinterpret_s32_u32(vshr_n_u32(
+      vreinterpret_u32_s32(vqdmulh_n_s32(hi_lo, int32_t(div10k_sig))), 9));
+  int32x2_t efgh_abcd_mnop_ijkl_32 =
+      vmla_n_s32(hi_lo, abcd_ijkl, 0x10000 - 10000);
+  int32x4_t efgh_abcd_mnop_ijkl = vreinterpretq_s32_u32(
+      vshll_n_u16(vreinterpret_u16_s32(efgh_abcd_mnop_ijkl_32), 0));
+  uint8x16_t digits = vrev64q_u8(to_bcd_4x4(efgh_abcd_mnop_ijkl));
+  uint8x16_t is_not_zero = vcgtzq_s8(vreinterpretq_s8_u8(digits));
+  uint64_t nonzero_mask = vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(is_not_zero), 4)),
+      0);
+  vst1q_u8(reinterpret_cast<uint8_t*>(buffer),
+           vaddq_u8(digits, vdupq_n_u8('0')));
+  // Four mask bits per digit; the last digit is kept even if it is zero.
+  return std::countr_zero(nonzero_mask | uint64_t(1) << 60) / 4;
+#elif BCD_ITOA_USE_SSE
+  __m128i x = _mm_set_epi64x(int64_t(hi), int64_t(lo));
+  __m128i y = _mm_add_epi64(
+      x, _mm_mul_epu32(_mm_set1_epi64x(neg10k),
+                       _mm_srli_epi64(
+                           _mm_mul_epu32(x, _mm_set1_epi64x(div10k_sig)),
+                           div10k_exp)));
+#  ifdef __SSE4_1__
+  __m128i bcd = _mm_shuffle_epi8(
+      to_bcd_4x4(y),
+      _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+#  else
+  __m128i bcd = to_bcd_4x4(_mm_shuffle_epi32(y, _MM_SHUFFLE(0, 1, 2, 3)));
+#  endif
+  int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(bcd, _mm_setzero_si128()));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer),
+                   _mm_or_si128(bcd, _mm_set1_epi8('0')));
+  return std::countr_zero(unsigned(mask) | 1u << 15);
+#else
+  uint64_t hi_bcd = to_bcd8(hi), lo_bcd = to_bcd8(lo);
+  uint64_t hi_digits = hi_bcd + zeros, lo_digits = lo_bcd + zeros;
+  memcpy(buffer, &hi_digits, 8);
+  memcpy(buffer + 8, &lo_digits, 8);
+  // The last digit is kept even if it is zero.
+  uint64_t first = hi_bcd ? hi_bcd
+                          : lo_bcd | (is_big_endian ? 1 : uint64_t(1) << 56);
+  int num_zeros =
+      (is_big_endian ? std::countl_zero(first) : std::countr_zero(first)) / 8;
+  return hi_bcd ? num_zeros : 8 + num_zeros;
+#endif
+}
+
+// Writes value < 10**8 without leading zeros, storing 8 bytes.
+inline auto write8(uint32_t value, char* buffer) noexcept -> char* {
+  uint64_t bcd = to_bcd8(value);
+  // The last digit is kept even if it is zero.
+  int num_zeros = 0;
+  uint64_t digits = bcd + zeros;
+  if (is_big_endian) {
+    num_zeros = std::countl_zero(bcd | 0xff) / 8;
+    digits <<= num_zeros * 8;
+  } else {
+    num_zeros = std::countr_zero(bcd | uint64_t(1) << 56) / 8;
+    digits >>= num_zeros * 8;
+  }
+  memcpy(buffer, &digits, 8);
+  return buffer + 8 - num_zeros;
+}
+
+// Writes 10**8 <= value < 10**16 without leading zeros, storing 16 bytes.
+inline auto write16(uint64_t value, char* buffer) noexcept -> char* {
+  int num_zeros = write_digits16(value, buffer);
+  memmove(buffer, buffer + num_zeros, 16);
+  return buffer + 16 - num_zeros;
+}
+
+inline auto write(uint64_t value, char* buffer) noexcept -> char* {
+  if (value < 100'000'000) return write8(uint32_t(value), buffer);
+  if (value < 10'000'000'000'000'000) return write16(value, buffer);
+  // 17 to 20 digits: up to 4 leading ones and 16 with leading zeros.
+  buffer = write8(uint32_t(value / 10'000'000'000'000'000), buffer);
+  write_digits16(value % 10'000'000'000'000'000, buffer);
+  return buffer + 16;
+}
+
+inline auto write(uint32_t value, char* buffer) noexcept -> char* {
+  if (value < 100'000'000) return write8(value, buffer);
+  return write16(value, buffer);
+}
+
+inline auto write(int64_t value, char* buffer) noexcept -> char* {
+  auto abs_value = uint64_t(value);
+  if (value < 0) {
+    *buffer++ = '-';
+    abs_value = 0 - abs_value;
+  }
+  return write(abs_value, buffer);
+}
+
+}  // namespace bcd_itoa
+
+#endif  // BCD_ITOA_H_
@@ -5,23 +5,42 @@
 #include "benchmark.h"
 
 #include <benchmark/benchmark.h>
-#include <math.h>    // isnan, isinf
+#include <float.h>   // LDBL_MANT_DIG
+#include <math.h>    // isnan, isinf, ldexp
 #include <stdint.h>  // uint64_t
 #include <stdio.h>   // snprintf
+#include <stdlib.h>  // atoi, malloc, realloc
 #include <string.h>  // memcpy, strcmp, strlen
 
 #include <algorithm>  // std::sort, std::shuffle
+#include <atomic>
+#include <charconv>   // std::to_chars
 #include <cmath>      // std::abs
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <limits>
-#include <random>  // std::mt19937
+#include <map>
+#include <random>     // std::mt19937
+#include <stdexcept>  // std::invalid_argument, std::runtime_error
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "alloc-counter.h"
+#include "dataset-cache.h"
 #include "double-conversion/double-conversion.h"
 #include "fmt/format.h"
+#include "output-arena.h"
+#include "plugin-loader.h"
+#include "results.h"
+#include "table-placement.h"
+
+#ifdef DTOA_HAVE_QUADMATH
+#  include <quadmath.h>  // quadmath_snprintf, strtoflt128
+#endif
 
 namespace {
 
@@ -31,37 +50,19 @@ constexpr int num_doubles_per_digit = 100'000;
 struct method {
   std::string name;
   dtoa_fun dtoa;
+  std::string reference;  // Method whose output must match, if any.
+  int max_write = 0;      // Declared bound on bytes written, 0 if none.
+  dtoa_length_fun length = nullptr;  // Exact output size, if any.
+  dtoa_loop_fun loop = nullptr;      // Inlinable benchmark loop, if any.
 };
 
 std::vector<method> methods;
 
-#ifndef MACHINE
-#  define MACHINE "unknown"
-#endif
-
-auto os_name() -> const char* {
-#if defined(__linux__)
-  return "linux";
-#elif defined(__APPLE__)
-  return "macos";
-#elif defined(_WIN32)
-  return "windows";
-#endif
-  return "unknown";
-}
-
-#define DO_STRINGIFY(x) #x
-#define STRINGIFY(x) DO_STRINGIFY(x)
-
-auto compiler_name() -> const char* {
-#if defined(__clang__)
-  return "clang" STRINGIFY(__clang_major__) "." STRINGIFY(__clang_minor__);
-#elif defined(__GNUC__)
-  return "gcc" STRINGIFY(__GNUC__) "." STRINGIFY(__GNUC_MINOR__);
-#elif defined(_MSC_VER)
-  return "msvc";
-#endif
-  return "unknown";
+auto find_method(std::string_view name) -> const method* {
+  for (const method& m : methods) {
+    if (m.name == name) return &m;
+  }
+  return nullptr;
 }
 
 struct from_chars_result {
@@ -101,15 +102,67 @@ class rng {
   }
 };
 
+// Returns the number of bytes `dtoa` stores from the output pointer on,
+// including scratch bytes past the returned end, and -1 if it stores anything
+// in front of the pointer. A byte counts as stored if it differs from the
+// guard pattern for either of two patterns.
+auto bytes_written(dtoa_fun dtoa, double value) -> int {
+  constexpr int guard_size = 64;
+  char area[guard_size + 1024];
+  int written = 0;
+  for (unsigned char guard : {0xcd, 0x5a}) {
+    memset(area, guard, sizeof(area));
+    dtoa(value, area + guard_size);
+    for (int i = 0; i < guard_size; ++i) {
+      if (area[i] != char(guard)) return -1;
+    }
+    for (int i = int(sizeof(area)) - 1; i >= guard_size; --i) {
+      if (area[i] != char(guard)) {
+        written = std::max(written, i - guard_size + 1);
+        break;
+      }
+    }
+  }
+  return written;
+}
+
+auto get_mixed_pool() -> const std::vector<double>&;
+
 void verify(const method& m) {
   if (m.name == "null") return;
 
   fmt::print("Verifying {:20} ... ", m.name);
 
+  const method* ref = nullptr;
+  if (!m.reference.empty()) {
+    ref = find_method(m.reference);
+    if (!ref) {
+      fmt::print("error: unknown reference method {}\n", m.reference);
+      throw std::exception();
+    }
+  }
+
   bool first = true;
+  alloc_stats allocs;
+  int max_written = 0;
   auto verify_value = [&](double value, dtoa_fun dtoa, const char* expected) {
     char buffer[1024] = {};
+    start_alloc_counting();
     *dtoa(value, buffer) = '\0';
+    alloc_stats s = stop_alloc_counting();
+    allocs.allocations += s.allocations;
+    allocs.bytes += s.bytes;
+    allocs.locale_lookups += s.locale_lookups;
+
+    if (ref) {
+      char ref_buffer[1024] = {};
+      *ref->dtoa(value, ref_buffer) = '\0';
+      if (strcmp(buffer, ref_buffer) != 0) {
+        fmt::print("error: {} -> '{}' but {} gives '{}'\n", value, buffer,
+                   ref->name, ref_buffer);
+        throw std::exception();
+      }
+    }
 
     if (expected && strcmp(buffer, expected) != 0) {
       if (first) {
@@ -130,6 +183,24 @@ void verify(const method& m) {
                  roundtrip);
       throw std::exception();
     }
+
+    if (m.length && m.length(value) != len) {
+      fmt::print("error: {} -> '{}' but length gives {}\n", value, buffer,
+                 m.length(value));
+      throw std::exception();
+    }
+
+    int written = bytes_written(dtoa, value);
+    if (written < 0) {
+      fmt::print("error: {} writes before the output pointer\n", value);
+      throw std::exception();
+    }
+    if (m.max_write != 0 && written > m.max_write) {
+      fmt::print("error: {} -> '{}' writes {} bytes but {} are declared\n",
+                 value, buffer, written, m.max_write);
+      throw std::exception();
+    }
+    max_written = std::max(max_written, written);
     return len;
   };
 
@@ -157,6 +228,25 @@ void verify(const method& m) {
        {std::numeric_limits<double>::denorm_min()}};
   for (auto c : cases) verify_value(c.value, m.dtoa, c.expected);
 
+  // Lengths are also checked on values that can't be compared after a round
+  // trip and on the mixed pool, which is mostly in fixed notation unlike the
+  // random bit patterns below.
+  if (m.length) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    auto check_length = [&](double value) {
+      char buffer[1024];
+      size_t len = m.dtoa(value, buffer) - buffer;
+      if (m.length(value) != len) {
+        fmt::print("error: {} -> '{}' but length gives {}\n", value,
+                   std::string_view(buffer, len), m.length(value));
+        throw std::exception();
+      }
+    };
+    for (double value : {-0.0, inf, -inf, std::nan(""), -std::nan("")})
+      check_length(value);
+    for (double value : get_mixed_pool()) check_length(value);
+  }
+
   rng r;
   size_t total_len = 0;
   size_t max_len = 0;
@@ -172,30 +262,44 @@ void verify(const method& m) {
   }
 
   double avg_len = double(total_len) / num_random_cases;
-  fmt::print("OK. Length Avg = {:2.3f}, Max = {}\n", avg_len, max_len);
+  std::string alloc_info = ", no allocations";
+  if (allocs.allocations != 0 || allocs.locale_lookups != 0) {
+    double n = std::size(cases) + num_random_cases;
+    alloc_info = fmt::format(
+        ", Allocs = {:.2f} ({:.0f} bytes), Locale = {:.2f} per double",
+        allocs.allocations / n, allocs.bytes / n, allocs.locale_lookups / n);
+  }
+  std::string write_info = fmt::format(", Writes = {}", max_written);
+  if (m.max_write != 0) write_info += fmt::format(" <= {}", m.max_write);
+  if (m.length) write_info += ", length exact";
+  fmt::print("OK. Length Avg = {:2.3f}, Max = {}{}{}{}\n", avg_len, max_len,
+             write_info, alloc_info, ref ? ", matches " + ref->name : "");
 }
 
+// All digit counts are drawn from one stream, as in the original
+// dtoa-benchmark, so they are generated and cached as one dataset.
+// column-scaling rebuilds the mixed pool from the same stream.
 auto get_random_digit_data(int digit) -> const double* {
-  static const std::vector<double> random_digit_data = []() {
-    std::vector<double> data;
-    data.reserve(num_doubles_per_digit * max_digits);
-    rng r;
-    for (int digit = 1; digit <= max_digits; ++digit) {
-      for (size_t i = 0; i < num_doubles_per_digit; ++i) {
-        double d = 0;
-        do {
-          d = r();
-        } while (isnan(d) || isinf(d));
-
-        // Limit the number of digits.
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "%.*g", digit, d);
-        data.push_back(from_chars(buffer).value);
-      }
-    }
-    return data;
-  }();
-  return random_digit_data.data() + (digit - 1) * num_doubles_per_digit;
+  static const double* random_digit_data = get_cached_dataset(
+      fmt::format("random-digit-d1to{}-n{}-seed0", max_digits,
+                  num_doubles_per_digit),
+      max_digits * num_doubles_per_digit, [](double* data) {
+        rng r;
+        for (int digits = 1; digits <= max_digits; ++digits) {
+          for (int i = 0; i < num_doubles_per_digit; ++i) {
+            double d = 0;
+            do {
+              d = r();
+            } while (isnan(d) || isinf(d));
+
+            // Limit the number of digits.
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "%.*g", digits, d);
+            *data++ = from_chars(buffer).value;
+          }
+        }
+      });
+  return random_digit_data + (digit - 1) * num_doubles_per_digit;
 }
 
 auto get_mixed_pool() -> const std::vector<double>& {
@@ -212,25 +316,287 @@ auto get_mixed_pool() -> const std::vector<double>& {
   return pool;
 }
 
-void run_random_digit(benchmark::State& state, dtoa_fun dtoa, int digit) {
-  const double* data = get_random_digit_data(digit);
+// The heatmap splits the binary exponents of finite doubles, from 2**-1074 to
+// 2**1023, into equal buckets and crosses them with the digit counts.
+constexpr int min_bin_exp = -1074;
+constexpr int max_bin_exp = 1023;
+constexpr int num_exp_buckets = 64;
+constexpr int num_doubles_per_cell = 1'000;
+// Per-cell minimum time in seconds; the grid has over a thousand cells.
+constexpr double heatmap_min_time = 0.01;
+
+// Returns the smallest binary exponent in `bucket`.
+auto exp_bucket_start(int bucket) -> int {
+  return min_bin_exp +
+         bucket * (max_bin_exp - min_bin_exp + 1) / num_exp_buckets;
+}
+
+auto get_heatmap_data(int bucket, int digit) -> const double* {
+  // Each bucket has its own seed so that the buckets can be generated and
+  // cached independently.
+  std::string key = fmt::format("heatmap-b{}of{}-n{}-seed{}", bucket,
+                                num_exp_buckets, num_doubles_per_cell, bucket);
+  const double* bucket_data = get_cached_dataset(
+      key, max_digits * num_doubles_per_cell, [bucket](double* data) {
+        std::mt19937_64 gen(bucket);
+        std::uniform_int_distribution<int> exp_dist(
+            exp_bucket_start(bucket), exp_bucket_start(bucket + 1) - 1);
+        for (int digit = 1; digit <= max_digits; ++digit) {
+          for (int i = 0; i < num_doubles_per_cell; ++i) {
+            double d = 0;
+            do {
+              // ldexp rounds to a subnormal for exponents below -1022.
+              double sig = 1 + double(gen() >> 11) * 0x1p-53;
+              d = ldexp(sig, exp_dist(gen));
+
+              // Limit the number of digits.
+              char buffer[64];
+              snprintf(buffer, sizeof(buffer), "%.*g", digit, d);
+              d = from_chars(buffer).value;
+            } while (d == 0 || isinf(d));
+            *data++ = d;
+          }
+        }
+      });
+  return bucket_data + (digit - 1) * num_doubles_per_cell;
+}
+
+// Fills the dataset cache with the per-digit and heatmap datasets using all
+// cores (--generate-datasets).
+void generate_datasets() {
+  std::vector<std::function<void()>> jobs;
+  jobs.push_back([] { get_random_digit_data(1); });
+  for (int b = 0; b < num_exp_buckets; ++b)
+    jobs.push_back([b] { get_heatmap_data(b, 1); });
+  std::atomic<size_t> next = 0;
+  std::vector<std::thread> threads;
+  unsigned num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&] {
+      for (size_t j = next++; j < jobs.size(); j = next++) jobs[j]();
+    });
+  }
+  for (std::thread& t : threads) t.join();
+  fmt::print("Generated {} datasets on {} threads\n", jobs.size(),
+             num_threads);
+}
+
+// Orderings of the mixed pool that sit between the two extremes for branch
+// prediction: the shuffled pool and the per-digit pools which feed a single
+// digit count at a time. All of them contain the same values.
+constexpr const char* orderings[] = {
+    "sorted-digits",  // All 1-digit values, then all 2-digit values, etc.
+    "sorted-exp",     // Sorted by binary exponent.
+    "runs10",         // Shuffled runs of 10 values with the same digit count.
+    "runs100",        // Same with runs of 100.
+    "runs1000",       // Same with runs of 1000.
+    "alternating",    // Digit counts 1, 17, 2, 16, ... in turn.
+};
+
+auto make_ordered_pool(std::string_view order) -> std::vector<double> {
+  std::vector<double> v;
+  v.reserve(num_doubles_per_digit * max_digits);
+  if (order == "sorted-digits") {
+    for (int d = 1; d <= max_digits; ++d) {
+      const double* p = get_random_digit_data(d);
+      v.insert(v.end(), p, p + num_doubles_per_digit);
+    }
+  } else if (order == "sorted-exp") {
+    v = get_mixed_pool();
+    auto biased_exp = [](double x) {
+      uint64_t bits = 0;
+      memcpy(&bits, &x, sizeof(x));
+      return (bits >> 52) & 0x7ff;
+    };
+    std::stable_sort(v.begin(), v.end(), [&](double lhs, double rhs) {
+      return biased_exp(lhs) < biased_exp(rhs);
+    });
+  } else if (order.substr(0, 4) == "runs") {
+    int run_length = std::stoi(std::string(order.substr(4)));
+    std::vector<int> runs;  // Digit count of each run.
+    for (int d = 1; d <= max_digits; ++d)
+      runs.insert(runs.end(), num_doubles_per_digit / run_length, d);
+    std::shuffle(runs.begin(), runs.end(), std::mt19937(0));
+    int next[max_digits + 1] = {};
+    for (int d : runs) {
+      const double* p = get_random_digit_data(d) + next[d];
+      v.insert(v.end(), p, p + run_length);
+      next[d] += run_length;
+    }
+  } else if (order == "alternating") {
+    for (int i = 0; i < num_doubles_per_digit; ++i) {
+      for (int lo = 1, hi = max_digits; lo <= hi; ++lo, --hi) {
+        v.push_back(get_random_digit_data(lo)[i]);
+        if (lo != hi) v.push_back(get_random_digit_data(hi)[i]);
+      }
+    }
+  }
+  return v;
+}
+
+auto get_ordered_pool(std::string_view order) -> const std::vector<double>& {
+  static std::map<std::string_view, std::vector<double>> pools;
+  auto it = pools.find(order);
+  if (it == pools.end()) it = pools.emplace(order, make_ordered_pool(order)).first;
+  return it->second;
+}
+
+// Edge-case classes that the random pools rarely or never contain. Values of
+// every class have a random sign.
+constexpr const char* special_classes[] = {
+    "zero",       // 0 and -0.
+    "inf",        // Infinities.
+    "nan",        // Quiet NaNs.
+    "subnormal",  // Random subnormals.
+    "pow10",      // Doubles nearest to 1e-307 ... 1e308.
+    "int",        // Integers in [0, 1e6).
+};
+
+auto make_special(std::string_view special_class, std::mt19937_64& gen)
+    -> double {
+  double d = 0;
+  if (special_class == "inf") {
+    d = std::numeric_limits<double>::infinity();
+  } else if (special_class == "nan") {
+    d = std::numeric_limits<double>::quiet_NaN();
+  } else if (special_class == "subnormal") {
+    uint64_t bits = gen() & ((uint64_t(1) << 52) - 1);
+    bits |= bits == 0;
+    memcpy(&d, &bits, sizeof(d));
+  } else if (special_class == "pow10") {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "1e%d", int(gen() % 616) - 307);
+    d = from_chars(buffer).value;
+  } else if (special_class == "int") {
+    d = double(gen() % 1'000'000);
+  }
+  return gen() & 1 ? -d : d;
+}
+
+// A dataset mixing edge cases into the mixed pool, specified as terms
+// "<class><percent>" joined with '+', e.g. "zero30+nan5". A class without a
+// percentage, e.g. "zero", makes up the whole dataset.
+struct special_term {
+  std::string special_class;
+  int percent;
+};
+
+auto parse_special_spec(std::string_view spec) -> std::vector<special_term> {
+  std::vector<special_term> terms;
+  int total = 0;
+  while (!spec.empty()) {
+    auto term = spec.substr(0, spec.find('+'));
+    spec.remove_prefix(std::min(spec.size(), term.size() + 1));
+    // Class names may end in digits themselves as in "pow10".
+    auto it = std::find_if(
+        std::begin(special_classes), std::end(special_classes),
+        [&](std::string_view c) { return term.substr(0, c.size()) == c; });
+    if (it == std::end(special_classes))
+      throw std::invalid_argument(fmt::format("unknown term '{}'", term));
+    auto special_class = std::string_view(*it);
+    auto rest = term.substr(special_class.size());
+    int percent = rest.empty() ? 100 : atoi(std::string(rest).c_str());
+    if (percent <= 0 || rest.find_first_not_of("0123456789") != rest.npos)
+      throw std::invalid_argument(fmt::format("invalid term '{}'", term));
+    total += percent;
+    terms.push_back({std::string(special_class), percent});
+  }
+  if (terms.empty() || total > 100)
+    throw std::invalid_argument("edge case percentages must add up to <= 100");
+  return terms;
+}
+
+auto make_special_pool(std::string_view spec) -> std::vector<double> {
+  auto terms = parse_special_spec(spec);
+  const auto& mixed = get_mixed_pool();
+  std::mt19937_64 gen(0);
+  std::vector<double> v;
+  v.reserve(num_doubles_per_digit);
+  for (int i = 0; i < num_doubles_per_digit; ++i) {
+    double d = mixed[i];
+    int r = int(gen() % 100);
+    for (const special_term& t : terms) {
+      if (r < t.percent) {
+        d = make_special(t.special_class, gen);
+        break;
+      }
+      r -= t.percent;
+    }
+    v.push_back(d);
+  }
+  return v;
+}
+
+auto get_special_pool(const std::string& spec) -> const std::vector<double>& {
+  static std::map<std::string, std::vector<double>> pools;
+  auto it = pools.find(spec);
+  if (it == pools.end()) it = pools.emplace(spec, make_special_pool(spec)).first;
+  return it->second;
+}
+
+// Names of the allocation counters, which are only written to the JSON.
+constexpr const char* alloc_counter_names[] = {"Allocs/double", "Bytes/double",
+                                               "Locale/double"};
+constexpr int num_alloc_samples = 10'000;
+
+// Counts allocations, allocated bytes and locale lookups per conversion in an
+// untimed pass over (up to num_alloc_samples of) the data, so that methods
+// that don't allocate are identified explicitly.
+void add_alloc_counters(benchmark::State& state, dtoa_fun dtoa,
+                        const double* data, int size) {
+  int n = std::min(size, num_alloc_samples);
+  char buffer[256];
+  start_alloc_counting();
+  for (int i = 0; i < n; ++i) dtoa(data[i], buffer);
+  alloc_stats stats = stop_alloc_counting();
+  state.counters[alloc_counter_names[0]] = double(stats.allocations) / n;
+  state.counters[alloc_counter_names[1]] = double(stats.bytes) / n;
+  state.counters[alloc_counter_names[2]] = double(stats.locale_lookups) / n;
+}
+
+void run_values(benchmark::State& state, dtoa_fun dtoa, const double* data,
+                int size) {
   char buffer[256];
   for (auto _ : state) {
-    for (int i = 0; i < num_doubles_per_digit; ++i) {
+    for (int i = 0; i < size; ++i) {
       char* end = dtoa(data[i], buffer);
       benchmark::DoNotOptimize(end);
       benchmark::ClobberMemory();
     }
   }
   state.counters["Throughput"] = benchmark::Counter(
-      double(num_doubles_per_digit), benchmark::Counter::kIsIterationInvariantRate);
+      double(size), benchmark::Counter::kIsIterationInvariantRate);
   state.counters["Time/double"] = benchmark::Counter(
-      double(num_doubles_per_digit), benchmark::Counter::kIsIterationInvariantRate |
-                                 benchmark::Counter::kInvert);
+      double(size), benchmark::Counter::kIsIterationInvariantRate |
+                        benchmark::Counter::kInvert);
+  add_alloc_counters(state, dtoa, data, size);
 }
 
-void run_mixed(benchmark::State& state, dtoa_fun dtoa) {
-  const auto& pool = get_mixed_pool();
+void run_random_digit(benchmark::State& state, dtoa_fun dtoa, int digit) {
+  run_values(state, dtoa, get_random_digit_data(digit), num_doubles_per_digit);
+}
+
+// Same as run_values with the loop instantiated for the method, see
+// register_method_inline.
+void run_inline(benchmark::State& state, dtoa_loop_fun loop,
+                const double* data, int size) {
+  char buffer[256];
+  for (auto _ : state) loop(data, size, buffer);
+  state.counters["Throughput"] = benchmark::Counter(
+      double(size), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/double"] = benchmark::Counter(
+      double(size), benchmark::Counter::kIsIterationInvariantRate |
+                        benchmark::Counter::kInvert);
+}
+
+void run_heatmap(benchmark::State& state, dtoa_fun dtoa, int bucket,
+                 int digit) {
+  run_values(state, dtoa, get_heatmap_data(bucket, digit),
+             num_doubles_per_cell);
+}
+
+void run_pool(benchmark::State& state, dtoa_fun dtoa,
+              const std::vector<double>& pool) {
   char buffer[256];
   for (auto _ : state) {
     for (double x : pool) {
@@ -244,17 +610,912 @@ void run_mixed(benchmark::State& state, dtoa_fun dtoa) {
   state.counters["Time/double"] = benchmark::Counter(
       double(pool.size()), benchmark::Counter::kIsIterationInvariantRate |
                                benchmark::Counter::kInvert);
+  add_alloc_counters(state, dtoa, pool.data(), int(pool.size()));
+}
+
+void run_mixed(benchmark::State& state, dtoa_fun dtoa) {
+  run_pool(state, dtoa, get_mixed_pool());
+}
+
+void run_ordered(benchmark::State& state, dtoa_fun dtoa, const char* order) {
+  run_pool(state, dtoa, get_ordered_pool(order));
+}
+
+void run_special(benchmark::State& state, dtoa_fun dtoa, std::string spec) {
+  run_pool(state, dtoa, get_special_pool(spec));
+}
+
+// Bulk output: conversions of the mixed pool are appended to an arena that is
+// reset every iteration instead of overwriting a stack buffer.
+constexpr const char* bulk_modes[] = {
+    "append",  // Straight into the arena, 4K pages.
+    "nt",      // Via an L1 staging buffer and non-temporal stores.
+    "huge",    // Straight into the arena, huge pages.
+    "bounce",  // Into a scratch buffer, then memcpy to the arena.
+    "packed",  // Straight into the arena while max_write bytes are left.
+};
+
+// Upper bound on the output of one value.
+constexpr size_t max_output_length = 32;
+
+// "bounce" is what a serializer has to do without a declared max_write, and
+// "packed" what it can do with one; only methods declaring it run "packed".
+void run_bulk(benchmark::State& state, dtoa_fun dtoa, std::string_view mode,
+              int max_write) {
+  const std::vector<double>& pool = get_mixed_pool();
+  output_arena arena(pool.size() * max_output_length, mode == "huge");
+  if (mode == "huge") state.SetLabel(arena.kind());
+  size_t bytes = 0;
+  char buffer[256];
+  for (double x : pool) bytes += dtoa(x, buffer) - buffer;
+  for (auto _ : state) {
+    char* out = arena.data();
+    if (mode == "nt") {
+      nt_appender appender(out);
+      for (double x : pool) appender.commit(dtoa(x, appender.pos()));
+      appender.flush();
+    } else if (mode == "bounce") {
+      for (double x : pool) {
+        size_t size = dtoa(x, buffer) - buffer;
+        memcpy(out, buffer, size);
+        out += size;
+      }
+    } else if (mode == "packed") {
+      // A serializer would flush here; the arena is large enough that this
+      // doesn't happen, but the check is part of the cost.
+      char* limit = arena.data() + arena.size() - max_write;
+      for (double x : pool) {
+        if (out > limit) [[unlikely]] out = arena.data();
+        out = dtoa(x, out);
+      }
+    } else {
+      for (double x : pool) out = dtoa(x, out);
+    }
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+  state.counters["Throughput"] = benchmark::Counter(
+      double(pool.size()), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/double"] = benchmark::Counter(
+      double(pool.size()), benchmark::Counter::kIsIterationInvariantRate |
+                               benchmark::Counter::kInvert);
+  state.counters["Output"] = benchmark::Counter(
+      double(bytes), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Output/double"] = double(bytes) / pool.size();
+}
+
+// Sizing (--sizing): the mixed pool as a column of values each followed by
+// '\n', written to a new buffer every iteration. "two-pass" allocates the
+// exact size from a length pass first, "realloc" grows the buffer as needed
+// and "length" is the length pass alone.
+constexpr const char* sizing_modes[] = {"length", "two-pass", "realloc"};
+
+// Initial capacity of the "realloc" column, doubled whenever it is full.
+constexpr size_t initial_column_capacity = 64 * 1024;
+
+void run_sizing(benchmark::State& state, dtoa_fun dtoa, dtoa_length_fun length,
+                std::string_view mode, int max_write) {
+  const std::vector<double>& pool = get_mixed_pool();
+  // Room for the bytes stored past the end of a value, and the separator.
+  size_t slack = (max_write != 0 ? max_write : max_output_length) + 1;
+  size_t bytes = 0;
+  for (auto _ : state) {
+    if (mode == "length") {
+      size_t size = 0;
+      for (double x : pool) size += length(x);
+      benchmark::DoNotOptimize(size);
+      continue;
+    }
+    char* column = nullptr;
+    char* out = nullptr;
+    if (mode == "two-pass") {
+      size_t size = pool.size();  // Separators.
+      for (double x : pool) size += length(x);
+      column = static_cast<char*>(malloc(size + slack));
+      out = column;
+      for (double x : pool) {
+        out = dtoa(x, out);
+        *out++ = '\n';
+      }
+    } else {
+      size_t capacity = initial_column_capacity;
+      column = static_cast<char*>(malloc(capacity));
+      out = column;
+      for (double x : pool) {
+        if (size_t(column + capacity - out) < slack) [[unlikely]] {
+          size_t size = out - column;
+          capacity *= 2;
+          column = static_cast<char*>(realloc(column, capacity));
+          out = column + size;
+        }
+        out = dtoa(x, out);
+        *out++ = '\n';
+      }
+    }
+    bytes = out - column;
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+    free(column);
+  }
+  state.counters["Throughput"] = benchmark::Counter(
+      double(pool.size()), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/double"] = benchmark::Counter(
+      double(pool.size()), benchmark::Counter::kIsIterationInvariantRate |
+                               benchmark::Counter::kInvert);
+  if (bytes != 0) {
+    state.counters["Output"] = benchmark::Counter(
+        double(bytes), benchmark::Counter::kIsIterationInvariantRate);
+  }
+}
+
+// Extended precision (--long-double): long double and binary128 methods on
+// digit sweeps of their own, 1-21 and 1-36 digits, the most needed for a
+// round trip.
+template <typename Float> struct extended_method {
+  std::string name;
+  auto (*dtoa)(Float, char*) -> char*;
+  std::string reference;
+};
+
+template <typename Float> struct extended_traits;
+
+// make() builds x87 80-bit values, so the long double track only exists where
+// long double has that format.
+#if LDBL_MANT_DIG == 64
+template <> struct extended_traits<long double> {
+  static constexpr const char* track = "ld";
+  static constexpr int max_digits = 21;  // LDBL_DECIMAL_DIG
+  static constexpr int num_fraction_bits = 63;
+
+  static auto methods() -> std::vector<extended_method<long double>>& {
+    static std::vector<extended_method<long double>> methods;
+    return methods;
+  }
+  // x87 extended: the integer bit is explicit.
+  static auto make(uint64_t fraction, unsigned bin_exp) -> long double {
+    uint64_t sig = fraction & ((uint64_t(1) << num_fraction_bits) - 1);
+    sig |= uint64_t(1) << num_fraction_bits;
+    uint16_t sign_exp = uint16_t(bin_exp);
+    long double value = 0;
+    memcpy(&value, &sig, sizeof(sig));
+    memcpy(reinterpret_cast<char*>(&value) + sizeof(sig), &sign_exp,
+           sizeof(sign_exp));
+    return value;
+  }
+  static void format(char* buffer, size_t size, int digits, long double x) {
+    snprintf(buffer, size, "%.*Lg", digits, x);
+  }
+  static auto parse(const char* s, char** end) -> long double {
+    return strtold(s, end);
+  }
+};
+#endif
+
+#ifdef DTOA_HAVE_QUADMATH
+template <> struct extended_traits<__float128> {
+  static constexpr const char* track = "f128";
+  static constexpr int max_digits = 36;  // FLT128_DECIMAL_DIG
+  static constexpr int num_fraction_bits = 112;
+
+  static auto methods() -> std::vector<extended_method<__float128>>& {
+    static std::vector<extended_method<__float128>> methods;
+    return methods;
+  }
+  static auto make(uint64_t fraction_hi, uint64_t fraction_lo,
+                   unsigned bin_exp) -> __float128 {
+    constexpr int num_hi_bits = num_fraction_bits - 64;
+    uint64_t hi = fraction_hi & ((uint64_t(1) << num_hi_bits) - 1);
+    hi |= uint64_t(bin_exp) << num_hi_bits;
+    unsigned __int128 bits = (unsigned __int128)hi << 64 | fraction_lo;
+    __float128 value = 0;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  static void format(char* buffer, size_t size, int digits, __float128 x) {
+    quadmath_snprintf(buffer, size, "%.*Qg", digits, x);
+  }
+  static auto parse(const char* s, char** end) -> __float128 {
+    return strtoflt128(s, end);
+  }
+};
+#endif
+
+constexpr int num_extended_per_digit = 10'000;
+
+// Random finite positive values with a uniformly distributed exponent.
+template <typename Float>
+auto random_extended(std::mt19937_64& gen) -> Float {
+  using traits = extended_traits<Float>;
+  unsigned bin_exp = 1 + gen() % 0x7ffe;
+  if constexpr (traits::num_fraction_bits > 64)
+    return traits::make(gen(), gen(), bin_exp);
+  else
+    return traits::make(gen(), bin_exp);
+}
+
+template <typename Float>
+auto get_extended_digit_data(int digit) -> const Float* {
+  using traits = extended_traits<Float>;
+  static const std::vector<Float> data = []() {
+    std::vector<Float> v;
+    v.reserve(num_extended_per_digit * traits::max_digits);
+    std::mt19937_64 gen(0);
+    for (int d = 1; d <= traits::max_digits; ++d) {
+      for (int i = 0; i < num_extended_per_digit; ++i) {
+        char buffer[128];
+        traits::format(buffer, sizeof(buffer), d, random_extended<Float>(gen));
+        v.push_back(traits::parse(buffer, nullptr));
+      }
+    }
+    return v;
+  }();
+  return data.data() + (digit - 1) * num_extended_per_digit;
+}
+
+// Checks edge cases and random values for a round trip through strtold or
+// strtoflt128 and, if given, byte-identical output to the reference.
+template <typename Float>
+void verify_extended(const extended_method<Float>& m) {
+  using traits = extended_traits<Float>;
+  fmt::print("Verifying {:20} ... ",
+             fmt::format("{}/{}", m.name, traits::track));
+
+  const extended_method<Float>* ref = nullptr;
+  for (const auto& other : traits::methods()) {
+    if (other.name == m.reference) ref = &other;
+  }
+  if (!m.reference.empty() && !ref) {
+    fmt::print("error: unknown reference method {}\n", m.reference);
+    throw std::exception();
+  }
+
+  size_t max_len = 0;
+  auto verify_value = [&](Float value) {
+    char buffer[256] = {};
+    *m.dtoa(value, buffer) = '\0';
+    if (ref) {
+      char ref_buffer[256] = {};
+      *ref->dtoa(value, ref_buffer) = '\0';
+      if (strcmp(buffer, ref_buffer) != 0) {
+        fmt::print("error: '{}' but {} gives '{}'\n", buffer, ref->name,
+                   ref_buffer);
+        throw std::exception();
+      }
+    }
+    char* end = nullptr;
+    Float roundtrip = traits::parse(buffer, &end);
+    size_t len = strlen(buffer);
+    if (size_t(end - buffer) != len) {
+      fmt::print("error: some extra character in '{}'\n", buffer);
+      throw std::exception();
+    }
+    if (roundtrip != value) {
+      fmt::print("error: roundtrip fail '{}'\n", buffer);
+      throw std::exception();
+    }
+    max_len = std::max(max_len, len);
+    return len;
+  };
+
+  using limits = std::numeric_limits<Float>;
+  const Float cases[] = {0,
+                         Float(1) / 10,
+                         Float(1) / 3,
+                         Float(2) / 3,
+                         1,
+                         2,
+                         1e20,
+                         -Float(1) / 3,
+                         limits::min(),
+                         limits::max(),
+                         limits::denorm_min()};
+  for (Float value : cases) verify_value(value);
+  // Powers of 2 have an asymmetric rounding interval.
+  for (Float p = limits::min(); p < limits::max() / 2; p *= 2) {
+    verify_value(p);
+  }
+
+  std::mt19937_64 gen(0);
+  size_t total_len = 0;
+  constexpr int num_random_cases = 100'000;
+  for (int i = 0; i < num_random_cases; ++i)
+    total_len += verify_value(random_extended<Float>(gen));
+
+  fmt::print("OK. Length Avg = {:2.3f}, Max = {}{}\n",
+             double(total_len) / num_random_cases, max_len,
+             ref ? ", matches " + ref->name : "");
 }
 
-void register_all(bool per_digit) {
+template <typename Float>
+void run_extended(benchmark::State& state, auto (*dtoa)(Float, char*)->char*,
+                  int digit) {
+  const Float* data = get_extended_digit_data<Float>(digit);
+  char buffer[256];
+  for (auto _ : state) {
+    for (int i = 0; i < num_extended_per_digit; ++i) {
+      char* end = dtoa(data[i], buffer);
+      benchmark::DoNotOptimize(end);
+      benchmark::ClobberMemory();
+    }
+  }
+  state.counters["Throughput"] = benchmark::Counter(
+      double(num_extended_per_digit),
+      benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/double"] = benchmark::Counter(
+      double(num_extended_per_digit),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+}
+
+// Verifies and registers <method>/<track>:d<digits> for each method.
+template <typename Float> void register_extended() {
+  using traits = extended_traits<Float>;
+  auto& methods = traits::methods();
+  std::sort(methods.begin(), methods.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.name < rhs.name;
+            });
+  for (const auto& m : methods) verify_extended(m);
+  for (const auto& m : methods) {
+    for (int d = 1; d <= traits::max_digits; ++d) {
+      std::string name = fmt::format("{}/{}:d{}", m.name, traits::track, d);
+      benchmark::RegisterBenchmark(name.c_str(), run_extended<Float>, m.dtoa,
+                                   d);
+    }
+  }
+}
+
+// 16-bit formats (--half): binary16 and bfloat16 have few enough values that
+// every finite one is verified and benchmarked.
+struct half_method {
+  std::string name;
+  half_format format;
+  htoa_fun htoa;
+  std::string reference;
+  htoa_batch_fun batch;
+};
+
+std::vector<half_method> half_methods;
+
+struct half_traits {
+  const char* track;
+  int num_sig_bits;
+  int num_exp_bits;
+};
+
+constexpr auto get_half_traits(half_format format) -> half_traits {
+  return format == half_format::binary16 ? half_traits{"f16", 10, 5}
+                                         : half_traits{"bf16", 7, 8};
+}
+
+auto is_half_nan(half_format format, uint16_t bits) -> bool {
+  half_traits t = get_half_traits(format);
+  return (bits & 0x7fff) > ((1u << t.num_exp_bits) - 1) << t.num_sig_bits;
+}
+
+// Rounds a double to the nearest value of the format, ties to even.
+auto half_from_double(half_format format, double value) -> uint16_t {
+  half_traits t = get_half_traits(format);
+  const int exp_mask = (1 << t.num_exp_bits) - 1;
+  const uint16_t sign = std::signbit(value) ? 0x8000 : 0;
+  const uint16_t inf = uint16_t(exp_mask << t.num_sig_bits);
+  value = std::fabs(value);
+  if (std::isnan(value)) return inf | 1;
+  if (value == 0) return sign;
+  if (std::isinf(value)) return sign | inf;
+  const int min_exp = 2 - (1 << (t.num_exp_bits - 1));
+  int exp = 0;
+  std::frexp(value, &exp);
+  exp = std::max(exp - 1, min_exp);
+  auto sig = uint32_t(std::nearbyint(std::ldexp(value, t.num_sig_bits - exp)));
+  const uint32_t implicit_bit = uint32_t(1) << t.num_sig_bits;
+  if (sig == implicit_bit << 1) {
+    sig >>= 1;
+    ++exp;
+  }
+  if (sig < implicit_bit) return sign | uint16_t(sig);  // Subnormal.
+  int biased_exp = exp - min_exp + 1;
+  if (biased_exp >= exp_mask) return sign | inf;
+  return sign | uint16_t(biased_exp << t.num_sig_bits | (sig - implicit_bit));
+}
+
+constexpr int num_half_normal = 100'000;
+
+// "all": every finite value in random order, "normal": N(0, 1) samples
+// rounded to the format, e.g. activations or weights.
+auto get_half_data(half_format format, std::string_view dataset)
+    -> const std::vector<uint16_t>& {
+  static std::map<std::pair<half_format, std::string>, std::vector<uint16_t>>
+      data;
+  auto key = std::pair(format, std::string(dataset));
+  auto it = data.find(key);
+  if (it != data.end()) return it->second;
+  std::vector<uint16_t> v;
+  if (dataset == "all") {
+    half_traits t = get_half_traits(format);
+    uint32_t exp_mask = (1u << t.num_exp_bits) - 1;
+    for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+      if (((bits >> t.num_sig_bits) & exp_mask) != exp_mask)
+        v.push_back(uint16_t(bits));
+    }
+    std::shuffle(v.begin(), v.end(), std::mt19937(0));
+  } else {
+    std::mt19937_64 gen(0);
+    std::normal_distribution<double> dist;
+    for (int i = 0; i < num_half_normal; ++i)
+      v.push_back(half_from_double(format, dist(gen)));
+  }
+  return data.emplace(key, std::move(v)).first->second;
+}
+
+// Checks every value for a round trip through strtod and, if given,
+// byte-identical output to the reference, and that the batch output is the
+// same as converting the values one by one.
+void verify_half(const half_method& m) {
+  half_traits t = get_half_traits(m.format);
+  fmt::print("Verifying {:20} ... ", fmt::format("{}/{}", m.name, t.track));
+
+  const half_method* ref = nullptr;
+  for (const half_method& other : half_methods) {
+    if (other.format == m.format && other.name == m.reference) ref = &other;
+  }
+  if (!m.reference.empty() && !ref) {
+    fmt::print("error: unknown reference method {}\n", m.reference);
+    throw std::exception();
+  }
+
+  size_t total_len = 0, max_len = 0;
+  std::vector<uint16_t> values;
+  std::string expected_batch;
+  for (uint32_t i = 0; i <= 0xffff; ++i) {
+    auto bits = uint16_t(i);
+    if (is_half_nan(m.format, bits)) continue;
+    char buffer[64] = {};
+    *m.htoa(bits, buffer) = '\0';
+    if (ref) {
+      char ref_buffer[64] = {};
+      *ref->htoa(bits, ref_buffer) = '\0';
+      if (strcmp(buffer, ref_buffer) != 0) {
+        fmt::print("error: '{}' for {:#06x} but {} gives '{}'\n", buffer,
+                   bits, ref->name, ref_buffer);
+        throw std::exception();
+      }
+    }
+    char* end = nullptr;
+    double roundtrip = strtod(buffer, &end);
+    size_t len = strlen(buffer);
+    if (size_t(end - buffer) != len) {
+      fmt::print("error: some extra character in '{}'\n", buffer);
+      throw std::exception();
+    }
+    if (half_from_double(m.format, roundtrip) != bits) {
+      fmt::print("error: roundtrip fail '{}' for {:#06x}\n", buffer, bits);
+      throw std::exception();
+    }
+    total_len += len;
+    max_len = std::max(max_len, len);
+    values.push_back(bits);
+    expected_batch.append(buffer, len);
+    expected_batch += '\n';
+  }
+
+  if (m.batch) {
+    std::string batch(expected_batch.size() + 64, '\0');
+    char* end = m.batch(values.data(), values.size(), batch.data());
+    batch.resize(end - batch.data());
+    if (batch != expected_batch) {
+      fmt::print("error: batch output differs from single conversions\n");
+      throw std::exception();
+    }
+  }
+
+  fmt::print("OK. Length Avg = {:2.3f}, Max = {}{}\n",
+             double(total_len) / values.size(), max_len,
+             ref ? ", matches " + ref->name : "");
+}
+
+void run_half(benchmark::State& state, htoa_fun htoa,
+              const std::vector<uint16_t>* data) {
+  char buffer[64];
+  for (auto _ : state) {
+    for (uint16_t bits : *data) {
+      char* end = htoa(bits, buffer);
+      benchmark::DoNotOptimize(end);
+      benchmark::ClobberMemory();
+    }
+  }
+  state.counters["Throughput"] = benchmark::Counter(
+      double(data->size()), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/double"] = benchmark::Counter(
+      double(data->size()), benchmark::Counter::kIsIterationInvariantRate |
+                                benchmark::Counter::kInvert);
+}
+
+// Writes the values as a newline-separated column with the batch function or,
+// if there is none, one conversion at a time.
+void run_half_batch(benchmark::State& state, htoa_fun htoa,
+                    htoa_batch_fun batch, const std::vector<uint16_t>* data) {
+  std::vector<char> out(data->size() * 32);
+  size_t bytes = 0;
+  for (auto _ : state) {
+    char* end = out.data();
+    if (batch) {
+      end = batch(data->data(), data->size(), end);
+    } else {
+      for (uint16_t bits : *data) {
+        end = htoa(bits, end);
+        *end++ = '\n';
+      }
+    }
+    bytes = end - out.data();
+    benchmark::DoNotOptimize(end);
+    benchmark::ClobberMemory();
+  }
+  state.counters["Throughput"] = benchmark::Counter(
+      double(data->size()), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/double"] = benchmark::Counter(
+      double(data->size()), benchmark::Counter::kIsIterationInvariantRate |
+                                benchmark::Counter::kInvert);
+  state.counters["Output"] = benchmark::Counter(
+      double(bytes), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Verifies and registers <method>/<track>:<all|normal|batch> for each method.
+void register_half() {
+  std::sort(half_methods.begin(), half_methods.end(),
+            [](const half_method& lhs, const half_method& rhs) {
+              return std::pair(lhs.format, lhs.name) <
+                     std::pair(rhs.format, rhs.name);
+            });
+  for (const half_method& m : half_methods) verify_half(m);
+  for (const half_method& m : half_methods) {
+    const char* track = get_half_traits(m.format).track;
+    for (const char* dataset : {"all", "normal"}) {
+      std::string name = fmt::format("{}/{}:{}", m.name, track, dataset);
+      benchmark::RegisterBenchmark(name.c_str(), run_half, m.htoa,
+                                   &get_half_data(m.format, dataset));
+    }
+    std::string name = fmt::format("{}/{}:batch", m.name, track);
+    benchmark::RegisterBenchmark(name.c_str(), run_half_batch, m.htoa, m.batch,
+                                 &get_half_data(m.format, "normal"));
+  }
+}
+
+// Bounded shortest (--bounded): shortest output capped at a precision, as in
+// printf("%.9g"), for columns where 17 digits are wasted.
+struct bounded_method {
+  std::string name;
+  int precision;
+  dtoa_fun dtoa;
+};
+
+std::vector<bounded_method> bounded_methods;
+
+constexpr int num_bounded_random = 100'000;
+constexpr int num_bounded_per_digit = 1'000;
+
+// Values whose shortest digits end exactly halfway between two candidates at
+// some precision, e.g. 123456.5 for %.6g, which must be rounded from the exact
+// binary value, and ones that round up to the next power of 10.
+constexpr double bounded_edge_cases[] = {
+    0.5,         1.5,         2.5,           0.125,          123456.5,
+    123457.5,    1234565,     1234575,       0.1234565,      999999.5,
+    9999995,     0.9999995,   123456788.5,   123456789.5,    999999999.5,
+    1.0000000005, 123456789012.5, 999999999999.5, 1e15 + 0.5, 5e-324,
+    2.2250738585072014e-308, 1.7976931348623157e308, 1e-5, 0.0001, 100000,
+    1e6,         1e9,         1e12,          0.3,            2.675,
+    1.005,       1e23};
+
+// Checks that the output is byte-identical to snprintf("%.*g") for edge cases,
+// random bit patterns and samples of every digit count.
+void verify_bounded(const bounded_method& m) {
+  fmt::print("Verifying {:20} ... ",
+             fmt::format("{}/g{}", m.name, m.precision));
+  std::vector<double> values(std::begin(bounded_edge_cases),
+                             std::end(bounded_edge_cases));
+  for (double v : bounded_edge_cases) {
+    values.push_back(-v);
+    values.push_back(std::nextafter(v, 0.0));
+    values.push_back(std::nextafter(v, HUGE_VAL));
+  }
+  for (double v : {0.0, -0.0, double(HUGE_VAL), -double(HUGE_VAL)})
+    values.push_back(v);
+  std::mt19937_64 gen(0);
+  for (int i = 0; i < num_bounded_random; ++i) {
+    double v = 0;
+    do {
+      uint64_t bits = gen();
+      memcpy(&v, &bits, sizeof(v));
+    } while (std::isnan(v));
+    values.push_back(v);
+  }
+  for (int d = 1; d <= max_digits; ++d) {
+    const double* p = get_random_digit_data(d);
+    values.insert(values.end(), p, p + num_bounded_per_digit);
+  }
+
+  size_t total_len = 0, max_len = 0;
+  for (double value : values) {
+    char buffer[64] = {};
+    *m.dtoa(value, buffer) = '\0';
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%.*g", m.precision, value);
+    if (strcmp(buffer, expected) != 0) {
+      fmt::print("error: '{}' for {} but %.{}g gives '{}'\n", buffer, value,
+                 m.precision, expected);
+      throw std::exception();
+    }
+    size_t len = strlen(buffer);
+    total_len += len;
+    max_len = std::max(max_len, len);
+  }
+  fmt::print("OK. Length Avg = {:2.3f}, Max = {}, matches %.{}g\n",
+             double(total_len) / values.size(), max_len, m.precision);
+}
+
+// Verifies and registers <method>/g<precision>:<mixed|d<digits>> for each
+// method.
+void register_bounded() {
+  std::sort(bounded_methods.begin(), bounded_methods.end(),
+            [](const bounded_method& lhs, const bounded_method& rhs) {
+              return std::pair(lhs.precision, lhs.name) <
+                     std::pair(rhs.precision, rhs.name);
+            });
+  for (const bounded_method& m : bounded_methods) verify_bounded(m);
+  for (const bounded_method& m : bounded_methods) {
+    std::string name = fmt::format("{}/g{}:mixed", m.name, m.precision);
+    benchmark::RegisterBenchmark(name.c_str(), run_mixed, m.dtoa);
+    for (int d = 1; d <= max_digits; ++d) {
+      name = fmt::format("{}/g{}:d{}", m.name, m.precision, d);
+      benchmark::RegisterBenchmark(name.c_str(), run_random_digit, m.dtoa, d);
+    }
+  }
+}
+
+// Integers (--itoa): uint32, uint64 and int64 values, by number of digits and
+// mixed, the bulk of what JSON and CSV serializers write.
+template <typename Int> struct itoa_method {
+  std::string name;
+  auto (*itoa)(Int, char*) -> char*;
+};
+
+template <typename Int> struct itoa_traits {
+  static constexpr const char* track = std::is_same_v<Int, uint32_t>   ? "u32"
+                                       : std::is_same_v<Int, uint64_t> ? "u64"
+                                                                       : "i64";
+  // 10, 20 and 19 digits, not counting the sign.
+  static constexpr int max_digits = std::numeric_limits<Int>::digits10 + 1;
+
+  static auto methods() -> std::vector<itoa_method<Int>>& {
+    static std::vector<itoa_method<Int>> methods;
+    return methods;
+  }
+};
+
+constexpr int num_ints_per_digit = 100'000;
+
+// Values with `digit` digits, uniformly distributed, and half of them negative
+// for signed types.
+template <typename Int> auto get_itoa_digit_data(int digit) -> const Int* {
+  using traits = itoa_traits<Int>;
+  static const std::vector<Int> data = []() {
+    std::vector<Int> v;
+    v.reserve(num_ints_per_digit * traits::max_digits);
+    uint64_t min = 0, max = 9;
+    for (int d = 1; d <= traits::max_digits; ++d) {
+      if (d == traits::max_digits) max = std::numeric_limits<Int>::max();
+      std::mt19937_64 gen(d);
+      std::uniform_int_distribution<uint64_t> dist(min, max);
+      for (int i = 0; i < num_ints_per_digit; ++i) {
+        auto value = Int(dist(gen));
+        if (std::is_signed_v<Int> && gen() % 2 != 0) value = Int(0 - value);
+        v.push_back(value);
+      }
+      min = max + 1;
+      max = min * 10 - 1;
+    }
+    return v;
+  }();
+  return data.data() + (digit - 1) * num_ints_per_digit;
+}
+
+template <typename Int> auto get_itoa_mixed_pool() -> const std::vector<Int>& {
+  using traits = itoa_traits<Int>;
+  static const std::vector<Int> pool = [] {
+    const Int* p = get_itoa_digit_data<Int>(1);
+    std::vector<Int> v(p, p + num_ints_per_digit * traits::max_digits);
+    std::shuffle(v.begin(), v.end(), std::mt19937(0));
+    return v;
+  }();
+  return pool;
+}
+
+// Checks that the output is byte-identical to std::to_chars for powers of 10,
+// their neighbours, the limits and every value of the datasets.
+template <typename Int> void verify_itoa(const itoa_method<Int>& m) {
+  using traits = itoa_traits<Int>;
+  using limits = std::numeric_limits<Int>;
+  fmt::print("Verifying {:20} ... ",
+             fmt::format("{}/{}", m.name, traits::track));
+
+  std::vector<Int> values = {limits::min(), limits::max()};
+  for (uint64_t p = 1;; p *= 10) {
+    for (uint64_t v : {p - 1, p, p + 1}) {
+      if (v > uint64_t(limits::max())) continue;
+      values.push_back(Int(v));
+      if (std::is_signed_v<Int>) values.push_back(Int(0 - Int(v)));
+    }
+    if (p > uint64_t(limits::max()) / 10) break;
+  }
+  const Int* p = get_itoa_digit_data<Int>(1);
+  values.insert(values.end(), p, p + num_ints_per_digit * traits::max_digits);
+
+  size_t total_len = 0, max_len = 0;
+  for (Int value : values) {
+    char buffer[64] = {};
+    *m.itoa(value, buffer) = '\0';
+    char expected[64] = {};
+    *std::to_chars(expected, expected + sizeof(expected), value).ptr = '\0';
+    if (strcmp(buffer, expected) != 0) {
+      fmt::print("error: '{}' but to_chars gives '{}'\n", buffer, expected);
+      throw std::exception();
+    }
+    size_t len = strlen(buffer);
+    total_len += len;
+    max_len = std::max(max_len, len);
+  }
+  fmt::print("OK. Length Avg = {:2.3f}, Max = {}, matches to_chars\n",
+             double(total_len) / values.size(), max_len);
+}
+
+template <typename Int>
+void run_itoa(benchmark::State& state, auto (*itoa)(Int, char*)->char*,
+              const Int* data, size_t size) {
+  char buffer[64];
+  for (auto _ : state) {
+    for (size_t i = 0; i < size; ++i) {
+      char* end = itoa(data[i], buffer);
+      benchmark::DoNotOptimize(end);
+      benchmark::ClobberMemory();
+    }
+  }
+  state.counters["Throughput"] = benchmark::Counter(
+      double(size), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["Time/value"] = benchmark::Counter(
+      double(size), benchmark::Counter::kIsIterationInvariantRate |
+                        benchmark::Counter::kInvert);
+}
+
+// Verifies and registers <method>/<track>:<mixed|d<digits>> for each method.
+template <typename Int> void register_itoa() {
+  using traits = itoa_traits<Int>;
+  auto& methods = traits::methods();
+  std::sort(methods.begin(), methods.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return lhs.name < rhs.name;
+            });
+  for (const auto& m : methods) verify_itoa(m);
+  for (const auto& m : methods) {
+    const std::vector<Int>& pool = get_itoa_mixed_pool<Int>();
+    std::string name = fmt::format("{}/{}:mixed", m.name, traits::track);
+    benchmark::RegisterBenchmark(name.c_str(), run_itoa<Int>, m.itoa,
+                                 pool.data(), pool.size());
+    for (int d = 1; d <= traits::max_digits; ++d) {
+      name = fmt::format("{}/{}:d{}", m.name, traits::track, d);
+      benchmark::RegisterBenchmark(name.c_str(), run_itoa<Int>, m.itoa,
+                                   get_itoa_digit_data<Int>(d),
+                                   size_t(num_ints_per_digit));
+    }
+  }
+}
+
+// Loads a plug-in and adds its methods as <name>@<plug-in>. A reference that
+// is not an in-tree method names another method of the same plug-in.
+auto add_plugin(const std::string& path) -> loaded_plugin {
+  loaded_plugin plugin = load_plugin(path);
+  for (const dtoa_plugin_method& m : plugin.methods) {
+    std::string reference = m.reference ? m.reference : "";
+    if (!reference.empty() && !find_method(reference))
+      reference += "@" + plugin.name;
+    methods.push_back(method{std::string(m.name) + "@" + plugin.name, m.dtoa,
+                             reference, m.max_write, m.length});
+  }
+  return plugin;
+}
+
+struct run_options {
+  bool per_digit = true;
+  bool orderings = false;
+  bool heatmap = false;
+  bool specials = false;
+  bool bulk = false;
+  bool long_double = false;
+  bool half = false;
+  bool sizing = false;
+  bool bounded = false;
+  bool inlined = false;
+  bool itoa = false;
+  // Edge-case mixes for the specials, see parse_special_spec.
+  std::vector<std::string> special_mixes = {"zero30"};
+};
+
+void register_all(const run_options& options) {
   for (const auto& m : methods) {
-    if (per_digit) {
+    if (options.per_digit) {
       for (int d = 1; d <= max_digits; ++d) {
         std::string name = m.name + "/d" + std::to_string(d);
         benchmark::RegisterBenchmark(name.c_str(), run_random_digit, m.dtoa, d);
       }
     }
     benchmark::RegisterBenchmark(m.name.c_str(), run_mixed, m.dtoa);
+    if (options.orderings) {
+      for (const char* order : orderings) {
+        std::string name = m.name + "/order:" + order;
+        benchmark::RegisterBenchmark(name.c_str(), run_ordered, m.dtoa, order);
+      }
+    }
+    if (options.heatmap) {
+      for (int b = 0; b < num_exp_buckets; ++b) {
+        for (int d = 1; d <= max_digits; ++d) {
+          std::string name = fmt::format("{}/heatmap:{}/d{}", m.name,
+                                         exp_bucket_start(b), d);
+          benchmark::RegisterBenchmark(name.c_str(), run_heatmap, m.dtoa, b, d)
+              ->MinTime(heatmap_min_time);
+        }
+      }
+    }
+    if (options.specials) {
+      std::vector<std::string> specs(std::begin(special_classes),
+                                     std::end(special_classes));
+      specs.insert(specs.end(), options.special_mixes.begin(),
+                   options.special_mixes.end());
+      for (const std::string& spec : specs) {
+        std::string name = m.name + "/special:" + spec;
+        benchmark::RegisterBenchmark(name.c_str(), run_special, m.dtoa, spec);
+      }
+    }
+    if (options.bulk) {
+      for (const char* mode : bulk_modes) {
+        if (mode == std::string_view("packed") && m.max_write == 0) continue;
+        std::string name = m.name + "/bulk:" + mode;
+        benchmark::RegisterBenchmark(name.c_str(), run_bulk, m.dtoa, mode,
+                                     m.max_write);
+      }
+    }
+    if (options.inlined && m.loop) {
+      const std::vector<double>& pool = get_mixed_pool();
+      std::string name = m.name + "/inline:mixed";
+      benchmark::RegisterBenchmark(name.c_str(), run_inline, m.loop,
+                                   pool.data(), int(pool.size()));
+      for (int d = 1; options.per_digit && d <= max_digits; ++d) {
+        name = fmt::format("{}/inline:d{}", m.name, d);
+        benchmark::RegisterBenchmark(name.c_str(), run_inline, m.loop,
+                                     get_random_digit_data(d),
+                                     num_doubles_per_digit);
+      }
+    }
+    if (options.sizing && m.length) {
+      for (const char* mode : sizing_modes) {
+        std::string name = m.name + "/sizing:" + mode;
+        benchmark::RegisterBenchmark(name.c_str(), run_sizing, m.dtoa,
+                                     m.length, mode, m.max_write);
+      }
+    }
+  }
+  if (options.long_double) {
+#if LDBL_MANT_DIG == 64
+    register_extended<long double>();
+#endif
+#ifdef DTOA_HAVE_QUADMATH
+    register_extended<__float128>();
+#endif
+  }
+  if (options.half) register_half();
+  if (options.bounded) register_bounded();
+  if (options.itoa) {
+    register_itoa<uint32_t>();
+    register_itoa<uint64_t>();
+    register_itoa<int64_t>();
   }
 }
 
@@ -291,6 +1552,11 @@ class pretty_reporter : public benchmark::ConsoleReporter {
     Run copy = report;
     std::string cells;
     for (const auto& kv : copy.counters) {
+      // Allocation counters are summarized by verify() instead.
+      if (std::find(std::begin(alloc_counter_names),
+                    std::end(alloc_counter_names),
+                    kv.first) != std::end(alloc_counter_names))
+        continue;
       const auto& c = kv.second;
       const char* unit = "";
       if (c.flags & benchmark::Counter::kIsRate)
@@ -312,21 +1578,123 @@ class pretty_reporter : public benchmark::ConsoleReporter {
 
 }  // namespace
 
-register_method::register_method(const char* name, dtoa_fun dtoa) {
-  methods.push_back(method{name, dtoa});
+register_method::register_method(const char* name, dtoa_fun dtoa,
+                                 const char* reference, int max_write,
+                                 dtoa_length_fun length, dtoa_loop_fun loop) {
+  methods.push_back(method{name, dtoa, reference ? reference : "", max_write,
+                           length, loop});
+}
+
+register_ldtoa_method::register_ldtoa_method(const char* name, ldtoa_fun dtoa,
+                                             const char* reference) {
+#if LDBL_MANT_DIG == 64
+  extended_traits<long double>::methods().push_back(
+      {name, dtoa, reference ? reference : ""});
+#endif
+}
+
+register_htoa_method::register_htoa_method(const char* name,
+                                           half_format format, htoa_fun htoa,
+                                           const char* reference,
+                                           htoa_batch_fun batch) {
+  half_methods.push_back(
+      {name, format, htoa, reference ? reference : "", batch});
+}
+
+register_bounded_method::register_bounded_method(const char* name,
+                                                 int precision,
+                                                 dtoa_fun dtoa) {
+  bounded_methods.push_back({name, precision, dtoa});
+}
+
+template <typename Int>
+static void add_itoa_method(const char* name, auto (*itoa)(Int, char*)->char*) {
+  itoa_traits<Int>::methods().push_back({name, itoa});
+}
+
+register_itoa_method::register_itoa_method(const char* name, u32toa_fun itoa) {
+  add_itoa_method(name, itoa);
+}
+
+register_itoa_method::register_itoa_method(const char* name, u64toa_fun itoa) {
+  add_itoa_method(name, itoa);
 }
 
+register_itoa_method::register_itoa_method(const char* name, i64toa_fun itoa) {
+  add_itoa_method(name, itoa);
+}
+
+#ifdef __SIZEOF_FLOAT128__
+register_f128toa_method::register_f128toa_method(const char* name,
+                                                 f128toa_fun dtoa,
+                                                 const char* reference) {
+#  ifdef DTOA_HAVE_QUADMATH
+  extended_traits<__float128>::methods().push_back(
+      {name, dtoa, reference ? reference : ""});
+#  endif
+}
+#endif
+
 auto main(int argc, char** argv) -> int {
-  bool per_digit = true;
+  run_options options;
+  bool special_mix_given = false;
   std::string commit_hash;
   std::string json_out;
+  const char* table_placement_kind = "rodata";
+  std::vector<loaded_plugin> plugins;
+  bool datasets_only = false;
   int out = 1;
   for (int i = 1; i < argc; ++i) {
     auto arg = std::string_view(argv[i]);
     if (arg == "--per-digit") {
-      per_digit = true;
+      options.per_digit = true;
     } else if (arg == "--no-per-digit") {
-      per_digit = false;
+      options.per_digit = false;
+    } else if (arg == "--orderings") {
+      options.orderings = true;
+    } else if (arg == "--heatmap") {
+      options.heatmap = true;
+    } else if (arg == "--specials") {
+      options.specials = true;
+    } else if (arg == "--bulk") {
+      options.bulk = true;
+    } else if (arg == "--long-double") {
+      options.long_double = true;
+    } else if (arg == "--half") {
+      options.half = true;
+    } else if (arg == "--sizing") {
+      options.sizing = true;
+    } else if (arg == "--bounded") {
+      options.bounded = true;
+    } else if (arg == "--inline") {
+      options.inlined = true;
+    } else if (arg == "--itoa") {
+      options.itoa = true;
+    } else if (arg == "--generate-datasets") {
+      datasets_only = true;
+    } else if (arg == "--no-dataset-cache") {
+      disable_dataset_cache();
+    } else if (arg.substr(0, 14) == "--special-mix=") {
+      options.specials = true;
+      if (!special_mix_given) options.special_mixes.clear();
+      special_mix_given = true;
+      auto spec = std::string(arg.substr(14));
+      try {
+        parse_special_spec(spec);
+      } catch (const std::invalid_argument& e) {
+        fmt::print("error: invalid --special-mix '{}': {}\n", spec, e.what());
+        return 1;
+      }
+      options.special_mixes.push_back(spec);
+    } else if (arg == "--huge-page-tables") {
+      table_placement_kind = place_tables(table_placement::huge_page);
+    } else if (arg.substr(0, 9) == "--plugin=") {
+      try {
+        plugins.push_back(add_plugin(std::string(arg.substr(9))));
+      } catch (const std::runtime_error& e) {
+        fmt::print("error: cannot load plug-in: {}\n", e.what());
+        return 1;
+      }
     } else if (arg.substr(0, 14) == "--commit-hash=") {
       commit_hash = std::string(arg.substr(14));
     } else if (arg.substr(0, 11) == "--json-out=") {
@@ -337,21 +1705,22 @@ auto main(int argc, char** argv) -> int {
   }
   argc = out;
 
+  if (datasets_only) {
+    generate_datasets();
+    return 0;
+  }
+
   std::sort(
       methods.begin(), methods.end(),
       [](const method& lhs, const method& rhs) { return lhs.name < rhs.name; });
 
   for (const method& m : methods) verify(m);
 
-  // Default output path matches the layout consumed by generate-html.py:
-  // results/<machine>_<os>_<compiler>_<commit>.json
-  if (json_out.empty() && per_digit) {
-    std::string suffix = commit_hash.empty() ? "" : "_" + commit_hash;
-    json_out = fmt::format("results/{}_{}_{}{}.json", MACHINE, os_name(),
-                           compiler_name(), suffix);
-  }
+  // Default output path matches the layout consumed by generate-html.py.
+  if (json_out.empty() && options.per_digit)
+    json_out = results_path(commit_hash);
 
-  register_all(per_digit);
+  register_all(options);
 
   // Google Benchmark requires --benchmark_out=<path> when a custom file
   // reporter is supplied, even though the reporter writes to its own stream.
@@ -366,14 +1735,13 @@ auto main(int argc, char** argv) -> int {
   if (benchmark::ReportUnrecognizedArguments(extra_argc, extra_argv.data()))
     return 1;
 
-  // Stash provenance in the JSON `context` block. This is in addition to the
-  // information already encoded in the file name so consumers don't have to
-  // parse the path.
-  benchmark::AddCustomContext("machine", MACHINE);
-  benchmark::AddCustomContext("os", os_name());
-  benchmark::AddCustomContext("compiler", compiler_name());
-  if (!commit_hash.empty())
-    benchmark::AddCustomContext("commit_hash", commit_hash);
+  add_results_context(commit_hash);
+  benchmark::AddCustomContext("table_placement", table_placement_kind);
+  for (const loaded_plugin& p : plugins) {
+    benchmark::AddCustomContext("plugin:" + p.name, p.path);
+    if (!p.build_id.empty())
+      benchmark::AddCustomContext("plugin:" + p.name + ":build_id", p.build_id);
+  }
 
   pretty_reporter console;
   std::ofstream json_file;
@@ -5,12 +5,133 @@
 #ifndef BENCHMARK_H_
 #define BENCHMARK_H_
 
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint16_t
+
 // Returns a pointer to one past the last character written. The result is not
 // required to be null-terminated.
 using dtoa_fun = auto (*)(double, char*) -> char*;
 
+// Returns the number of characters dtoa_fun writes for a value, excluding
+// scratch bytes, without producing the digits.
+using dtoa_length_fun = auto (*)(double) -> size_t;
+
+// Converts values[0, count) one at a time into the same buffer, the loop of
+// the benchmarks, with direct calls that can be inlined.
+using dtoa_loop_fun = void (*)(const double* values, size_t count,
+                               char* buffer);
+
 struct register_method {
-  register_method(const char* name, dtoa_fun dtoa);
+  // If `reference` names another registered method, verification also checks
+  // that `dtoa` produces byte-identical output to it.
+  //
+  // `max_write`, if nonzero, is the most bytes `dtoa` stores from the output
+  // pointer on, including any scratch bytes past the returned end. Callers
+  // may then convert directly into any buffer with that much room left.
+  //
+  // `length`, if given, must return the exact output size of `dtoa`, so that
+  // a column can be sized before it is written.
+  //
+  // `loop`, if given, is used for the --inline benchmarks, see
+  // register_method_inline.
+  register_method(const char* name, dtoa_fun dtoa,
+                  const char* reference = nullptr, int max_write = 0,
+                  dtoa_length_fun length = nullptr,
+                  dtoa_loop_fun loop = nullptr);
+};
+
+// Keeps the result of a conversion and the output it points to, like
+// benchmark::DoNotOptimize followed by benchmark::ClobberMemory.
+inline void keep_output(char* end) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r"(end) : "memory");
+#else
+  static char* volatile sink;
+  sink = end;
+#endif
+}
+
+// Registers a method like register_method, with the benchmark loop also
+// instantiated for the function object type `F`, so that the conversion is
+// called directly and can be inlined as it would be in application code.
+// --inline then reports <name>/inline:<dataset> next to the numbers measured
+// through dtoa_fun. `F` must be default-constructible, e.g. a lambda without
+// captures:
+//
+//   static register_method_inline _("fmt", [](double value, char* buffer) {
+//     return fmt::format_to(buffer, FMT_COMPILE("{}"), value);
+//   });
+template <typename F> struct register_method_inline : register_method {
+  register_method_inline(const char* name, F, const char* reference = nullptr,
+                         int max_write = 0, dtoa_length_fun length = nullptr)
+      : register_method(
+            name, [](double value, char* buffer) -> char* {
+              return F()(value, buffer);
+            },
+            reference, max_write, length, loop) {}
+
+  static void loop(const double* values, size_t count, char* buffer) {
+    for (size_t i = 0; i < count; ++i) keep_output(F()(values[i], buffer));
+  }
+};
+
+// Methods for the --bounded track: the shortest representation, rounded to at
+// most `precision` significant digits, which must match
+// printf("%.<precision>g") byte for byte. Verified against the C library
+// rather than by round trip.
+struct register_bounded_method {
+  register_bounded_method(const char* name, int precision, dtoa_fun dtoa);
+};
+
+// Extended-precision methods for the --long-double track, verified by
+// round trip through strtold and strtoflt128 respectively.
+using ldtoa_fun = auto (*)(long double, char*) -> char*;
+
+struct register_ldtoa_method {
+  register_ldtoa_method(const char* name, ldtoa_fun dtoa,
+                        const char* reference = nullptr);
+};
+
+#ifdef __SIZEOF_FLOAT128__
+using f128toa_fun = auto (*)(__float128, char*) -> char*;
+
+struct register_f128toa_method {
+  register_f128toa_method(const char* name, f128toa_fun dtoa,
+                          const char* reference = nullptr);
+};
+#endif
+
+// 16-bit formats for the --half track. Values are passed as bit patterns
+// because neither format is a portable C++ type.
+enum class half_format { binary16, bfloat16 };
+
+using htoa_fun = auto (*)(uint16_t bits, char*) -> char*;
+
+// Converts values[0, count), each followed by '\n', and returns the end.
+using htoa_batch_fun = auto (*)(const uint16_t* values, size_t count,
+                                char* out) -> char*;
+
+struct register_htoa_method {
+  // Verification is exhaustive: every finite value must round-trip and, if
+  // `reference` is given, match its output. `batch`, if given, is used for
+  // the batch benchmark instead of calling `htoa` in a loop.
+  register_htoa_method(const char* name, half_format format, htoa_fun htoa,
+                       const char* reference = nullptr,
+                       htoa_batch_fun batch = nullptr);
+};
+
+// Integers for the --itoa track, which JSON and CSV writers format far more
+// often than doubles. Each overload adds the method to the track of its
+// argument type, u32, u64 or i64, and verification checks that the output
+// matches std::to_chars byte for byte.
+using u32toa_fun = auto (*)(uint32_t, char*) -> char*;
+using u64toa_fun = auto (*)(uint64_t, char*) -> char*;
+using i64toa_fun = auto (*)(int64_t, char*) -> char*;
+
+struct register_itoa_method {
+  register_itoa_method(const char* name, u32toa_fun itoa);
+  register_itoa_method(const char* name, u64toa_fun itoa);
+  register_itoa_method(const char* name, i64toa_fun itoa);
 };
 
 #endif  // BENCHMARK_H_
@@ -0,0 +1,163 @@
+// Shortest output capped at a number of significant digits ("shortest, but
+// never more than 9 digits"), with the same bytes as printf("%.<N>g") in the
+// "C" locale.
+//
+// If the shortest representation of a normal double has at most N <= 15
+// digits, it is within half a unit in the N-th digit of the exact value, so it
+// is also the correctly rounded N-digit one. Otherwise the shortest digits are
+// rounded to N digits, which gives the same result as rounding the exact value
+// unless they end exactly halfway between two N-digit candidates; only then
+// the exact value decides, via Ryu's %e (ryu/d2fixed.c), which also handles
+// subnormals whose spacing exceeds a unit in the N-th digit.
+
+#ifndef BOUNDED_SHORTEST_H_
+#define BOUNDED_SHORTEST_H_
+
+#include <stdint.h>  // uint64_t
+#include <string.h>  // memcpy
+
+#include <bit>  // std::bit_width
+
+#include "dtoa-length.h"    // count_digits
+#include "printf-compat.h"  // write_general
+#include "ryu/ryu.h"
+
+namespace bounded_shortest {
+
+constexpr uint64_t pow10[] = {1,
+                              10,
+                              100,
+                              1'000,
+                              10'000,
+                              100'000,
+                              1'000'000,
+                              10'000'000,
+                              100'000'000,
+                              1'000'000'000,
+                              10'000'000'000,
+                              100'000'000'000,
+                              1'000'000'000'000,
+                              10'000'000'000'000,
+                              100'000'000'000'000,
+                              1'000'000'000'000'000,
+                              10'000'000'000'000'000,
+                              100'000'000'000'000'000};
+
+#ifdef __SIZEOF_INT128__
+// Division of x < 2**57 by 10**n without a division instruction:
+//   x / 10**n == x * multiplier >> (64 + shift)
+// with shift = floor(log2(10**n)) and multiplier = ceil(2**(64 + shift) /
+// 10**n), since the error x * (multiplier * 10**n - 2**(64 + shift)) is less
+// than x * 10**n < 2**(64 + shift).
+struct pow10_divisor {
+  uint64_t multiplier;
+  int shift;
+};
+
+constexpr auto make_pow10_divisors() {
+  struct table {
+    pow10_divisor data[17];
+  } t = {};
+  for (int n = 1; n < 17; ++n) {
+    int shift = std::bit_width(pow10[n]) - 1;
+    // ceil(2**(64 + shift) / 10**n) by long division of 2**shift * 2**64.
+    unsigned __int128 dividend = (unsigned __int128)(uint64_t(1) << shift)
+                                 << 64;
+    auto q = uint64_t(dividend / pow10[n]);
+    if (dividend % pow10[n] != 0) ++q;
+    t.data[n] = {q, shift};
+  }
+  return t;
+}
+
+constexpr auto pow10_divisors = make_pow10_divisors();
+#endif
+
+inline auto divide_pow10(uint64_t x, int n) noexcept -> uint64_t {
+#ifdef __SIZEOF_INT128__
+  const pow10_divisor& d = pow10_divisors.data[n];
+  return uint64_t(((unsigned __int128)x * d.multiplier) >> 64) >> d.shift;
+#else
+  return x / pow10[n];
+#endif
+}
+
+// Shortest representation sig * 10**exp; sig may have trailing zeros.
+struct decimal {
+  uint64_t sig;
+  int exp;
+};
+
+// Formats a positive finite value like printf("%.<precision>g") from the
+// exact digits given by Ryu's d[.ddd]e[+-]XX[X].
+template <int precision>
+auto write_exact(double value, char* out) noexcept -> char* {
+  char buffer[32];
+  int size = d2exp_buffered_n(value, precision - 1, buffer);
+  char digits[precision];
+  digits[0] = buffer[0];
+  memcpy(digits + 1, buffer + 2, precision - 1);
+  int e_pos = precision == 1 ? 1 : precision + 1;
+  int exp = 0;
+  for (int i = e_pos + 2; i < size; ++i) exp = exp * 10 + (buffer[i] - '0');
+  if (buffer[e_pos + 1] == '-') exp = -exp;
+  return printf_compat::write_general(out, digits, exp, precision);
+}
+
+// Formats `value` like printf("%.<precision>g", value) given a function
+// returning the shortest decimal of positive finite values.
+template <int precision, typename ToDecimal>
+auto write(double value, char* out, ToDecimal to_decimal) noexcept -> char* {
+  static_assert(precision >= 1 && precision <= 15,
+                "shortest fits in precision digits only if precision <= 15");
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(value));
+  if (bits >> 63) *out++ = '-';
+  bits &= ~(uint64_t(1) << 63);
+  if (bits >= uint64_t(0x7ff) << 52) {
+    memcpy(out, bits == uint64_t(0x7ff) << 52 ? "inf" : "nan", 3);
+    return out + 3;
+  }
+  if (bits == 0) {
+    *out = '0';
+    return out + 1;
+  }
+  memcpy(&value, &bits, sizeof(value));
+  // Subnormals have fewer significant bits than precision digits need.
+  if (bits < uint64_t(1) << 52) [[unlikely]]
+    return write_exact<precision>(value, out);
+
+  decimal dec = to_decimal(value);
+  uint64_t sig = dec.sig;
+  int exp = dec.exp;
+  int num_digits = dtoa_length::count_digits(sig);
+  exp += num_digits - 1;  // Exponent of the first digit.
+  uint64_t rounded = 0;
+  if (num_digits <= precision) {
+    rounded = sig * pow10[precision - num_digits];
+  } else {
+    int n = num_digits - precision;
+    rounded = divide_pow10(sig, n);
+    uint64_t remainder = sig - rounded * pow10[n];
+    uint64_t half = pow10[n] / 2;
+    // The shortest digits are a tie; round the exact value instead.
+    if (remainder == half) [[unlikely]]
+      return write_exact<precision>(value, out);
+    rounded += remainder > half;
+    if (rounded == pow10[precision]) {
+      rounded = pow10[precision - 1];
+      ++exp;
+    }
+  }
+
+  char digits[precision];
+  for (int i = precision - 1; i >= 0; --i) {
+    digits[i] = char('0' + rounded % 10);
+    rounded /= 10;
+  }
+  return printf_compat::write_general(out, digits, exp, precision);
+}
+
+}  // namespace bounded_shortest
+
+#endif  // BOUNDED_SHORTEST_H_
@@ -0,0 +1,44 @@
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "bounded-shortest.h"
+#include "dragonbox/dragonbox.h"
+#include "zmij/zmij.h"
+
+template <int precision>
+auto zmij_bounded(double value, char* buffer) -> char* {
+  return bounded_shortest::write<precision>(value, buffer, [](double v) {
+    auto dec = zmij::to_decimal(v);
+    return bounded_shortest::decimal{uint64_t(dec.sig), dec.exp};
+  });
+}
+
+template <int precision>
+auto dragonbox_bounded(double value, char* buffer) -> char* {
+  return bounded_shortest::write<precision>(value, buffer, [](double v) {
+    auto dec = jkj::dragonbox::to_decimal(v,
+                                          jkj::dragonbox::policy::sign::ignore,
+                                          jkj::dragonbox::policy::cache::full);
+    return bounded_shortest::decimal{dec.significand, dec.exponent};
+  });
+}
+
+template <int precision>
+auto sprintf_bounded(double value, char* buffer) -> char* {
+  return buffer + snprintf(buffer, 64, "%.*g", precision, value);
+}
+
+static register_bounded_method zmij6("zmij", 6, zmij_bounded<6>);
+static register_bounded_method zmij9("zmij", 9, zmij_bounded<9>);
+static register_bounded_method zmij12("zmij", 12, zmij_bounded<12>);
+
+static register_bounded_method dragonbox6("dragonbox", 6,
+                                          dragonbox_bounded<6>);
+static register_bounded_method dragonbox9("dragonbox", 9,
+                                          dragonbox_bounded<9>);
+static register_bounded_method dragonbox12("dragonbox", 12,
+                                           dragonbox_bounded<12>);
+
+static register_bounded_method sprintf6("sprintf", 6, sprintf_bounded<6>);
+static register_bounded_method sprintf9("sprintf", 9, sprintf_bounded<9>);
+static register_bounded_method sprintf12("sprintf", 12, sprintf_bounded<12>);
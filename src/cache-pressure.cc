@@ -5,10 +5,17 @@
 // then measure how long it takes to re-read the working set. Longer reload
 // means more cache lines were evicted by the dtoa code+data.
 //
-// Usage: ./cache-pressure [method] [calls_per_round]
+// Usage: ./cache-pressure [--profile-data] [--json-out=<path>]
+//                         [--commit-hash=<hash>] [method] [calls_per_round]
 // Run under: perf stat -e L1-dcache-loads,L1-dcache-load-misses ...
+//
+// Without a method filter the eviction curves are also written to
+// results/<machine>_<os>_<compiler>_<commit>.cache-pressure.json for
+// generate-html.py (see results.h).
 
 #include "benchmark.h"
+#include "profile-data.h"
+#include "results.h"
 
 #include <math.h>
 #include <stdint.h>
@@ -19,19 +26,37 @@
 #include <algorithm>
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Exactly one of the functions is set.
 struct method {
   std::string name;
-  dtoa_fun dtoa;
+  dtoa_fun dtoa = nullptr;
+  htoa_fun htoa = nullptr;
+  htoa_batch_fun batch = nullptr;
 };
 
 static std::vector<method> methods;
 
-register_method::register_method(const char* name, dtoa_fun dtoa) {
+register_method::register_method(const char* name, dtoa_fun dtoa,
+                                 const char*, int, dtoa_length_fun,
+                                 dtoa_loop_fun) {
   methods.push_back(method{name, dtoa});
 }
 
+// 16-bit methods are listed as <method>-f16 or <method>-bf16, and their batch
+// functions as <method>-batch-f16 or <method>-batch-bf16.
+register_htoa_method::register_htoa_method(const char* name,
+                                           half_format format, htoa_fun htoa,
+                                           const char*, htoa_batch_fun batch) {
+  std::string suffix = format == half_format::binary16 ? "-f16" : "-bf16";
+  methods.push_back(method{name + suffix, nullptr, htoa});
+  if (batch)
+    methods.push_back(method{name + ("-batch" + suffix), nullptr, nullptr,
+                             batch});
+}
+
 // Working set: 16KB = 256 cache lines on a 64-byte line size.
 // This fits comfortably in a 32KB L1d with room for stack/locals.
 static constexpr int NUM_CACHE_LINES = 256;
@@ -87,6 +112,17 @@ static void init_test_values() {
   }
 }
 
+// 64 random 16-bit values for the htoa methods.
+static uint16_t half_test_values[NUM_TEST_VALUES];
+
+static void init_half_test_values() {
+  unsigned seed = 42;
+  for (int i = 0; i < NUM_TEST_VALUES; i++) {
+    seed = 214013 * seed + 2531011;
+    half_test_values[i] = uint16_t(seed >> 16);
+  }
+}
+
 // Call dtoa exactly N times, cycling through test values.
 static void __attribute__((noinline))
 call_dtoa_n(dtoa_fun dtoa, int n) {
@@ -96,11 +132,52 @@ call_dtoa_n(dtoa_fun dtoa, int n) {
   }
 }
 
+static void __attribute__((noinline))
+call_htoa_n(htoa_fun htoa, int n) {
+  char buffer[256];
+  for (int i = 0; i < n; i++) {
+    htoa(half_test_values[i % NUM_TEST_VALUES], buffer);
+  }
+}
+
+// Converts n values with batch calls of at most NUM_TEST_VALUES each.
+static void __attribute__((noinline))
+call_batch_n(htoa_batch_fun batch, int n) {
+  char buffer[NUM_TEST_VALUES * 32];
+  for (int done = 0; done < n; done += NUM_TEST_VALUES)
+    batch(half_test_values, std::min(n - done, NUM_TEST_VALUES), buffer);
+}
+
 int main(int argc, char** argv) {
-  const char* filter = argc > 1 ? argv[1] : nullptr;
-  int calls_per_round = argc > 2 ? atoi(argv[2]) : 0;
+  // --profile-data replaces the test values with the narrow-band dataset
+  // from profile-data.h, e.g. to compare dragonbox-hot with dragonbox.
+  bool profile_data = false;
+  std::string json_out;
+  std::string commit_hash;
+  benchmark::Initialize(&argc, argv);
+  std::vector<const char*> args;
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    if (arg == "--profile-data")
+      profile_data = true;
+    else if (arg.starts_with("--json-out="))
+      json_out = arg.substr(strlen("--json-out="));
+    else if (arg.starts_with("--commit-hash="))
+      commit_hash = arg.substr(strlen("--commit-hash="));
+    else
+      args.push_back(argv[i]);
+  }
+  const char* filter = args.size() > 0 ? args[0] : nullptr;
+  int calls_per_round = args.size() > 1 ? atoi(args[1]) : 0;
+  if (json_out.empty() && !filter)
+    json_out = results_path(commit_hash, "cache-pressure");
 
   init_test_values();
+  init_half_test_values();
+  if (profile_data) {
+    auto values = make_profile_values(NUM_TEST_VALUES);
+    std::copy(values.begin(), values.end(), test_values);
+  }
 
   for (int i = 0; i < WORKING_SET_INTS; i++) {
     working_set[i] = i * 0x9e3779b97f4a7c15ULL;
@@ -145,6 +222,7 @@ int main(int argc, char** argv) {
   }
   printf("\n");
 
+  std::vector<result_row> rows;
   for (const auto& m : methods) {
     if (m.name == "null" || m.name == "ostringstream" || m.name == "sprintf")
       continue;
@@ -159,7 +237,12 @@ int main(int argc, char** argv) {
 
       for (int t = 0; t < NUM_TRIALS; t++) {
         load_working_set();           // Prime L1 with working set.
-        call_dtoa_n(m.dtoa, n);       // Pollute with dtoa.
+        if (m.dtoa)                   // Pollute with dtoa.
+          call_dtoa_n(m.dtoa, n);
+        else if (m.htoa)
+          call_htoa_n(m.htoa, n);
+        else
+          call_batch_n(m.batch, n);
         trials[t] = measure_reload_ns();
       }
 
@@ -168,6 +251,9 @@ int main(int argc, char** argv) {
       double penalty_ns = median_ns - baseline_ns;
 
       printf(" %9.0fns", penalty_ns);
+      // <method>/eviction:<calls>, plotted by generate-html.py.
+      rows.push_back({m.name + "/eviction:" + std::to_string(n), median_ns,
+                      NUM_TRIALS, {{"Penalty", penalty_ns * 1e-9}}});
     }
     printf("\n");
   }
@@ -176,5 +262,16 @@ int main(int argc, char** argv) {
          baseline_ns);
   printf("Higher = more L1 cache eviction = worse for co-resident hot paths\n");
 
+  if (json_out.empty()) return 0;
+  add_results_context(commit_hash);
+  benchmark::AddCustomContext("working_set_kb",
+                              std::to_string(NUM_CACHE_LINES * 64 / 1024));
+  benchmark::AddCustomContext("reload_baseline_ns",
+                              std::to_string((long long)baseline_ns));
+  if (!write_results(json_out, rows)) {
+    fprintf(stderr, "error: cannot write %s\n", json_out.c_str());
+    return 1;
+  }
+  printf("\nResults written to %s\n", json_out.c_str());
   return 0;
 }
@@ -0,0 +1,205 @@
+#include "column-formatter.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#  include "cpu-topology.h"  // pin_to_cpu
+#endif
+
+// Per-thread state. Aligned so that the range locks of different threads
+// don't share cache lines.
+struct alignas(64) column_formatter::worker {
+  std::mutex mutex;
+  size_t begin = 0;  // Remaining chunks [begin, end), guarded by mutex.
+  size_t end = 0;
+  size_t steals = 0;
+
+  // Arena: blocks of block_size bytes, reused across calls. Blocks are
+  // allocated and first touched by the thread that fills them.
+  std::vector<std::unique_ptr<char[]>> blocks;
+  size_t block_size = 0;
+  size_t block = 0;  // current block
+  size_t used = 0;   // bytes used in the current block
+
+  std::thread thread;
+};
+
+struct column_formatter::job {
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+  unsigned generation = 0;
+  int pending = 0;
+  bool stop = false;
+
+  dtoa_fun dtoa = nullptr;
+  size_t max_length = 0;  // per value
+  const double* values = nullptr;
+  size_t count = 0;
+  size_t chunk_size = 0;
+};
+
+column_formatter::column_formatter(int num_threads, bool pin, char separator)
+    : job_(new job), separator_(separator) {
+  num_threads = std::max(num_threads, 1);
+  for (int i = 0; i < num_threads; ++i) workers_.emplace_back(new worker);
+  for (int i = 0; i < num_threads - 1; ++i) {
+    workers_[i]->thread = std::thread([this, i, pin] {
+#ifdef __linux__
+      if (pin) pin_to_cpu(i % std::thread::hardware_concurrency());
+#endif
+      worker_loop(i);
+    });
+  }
+}
+
+column_formatter::~column_formatter() {
+  {
+    std::lock_guard<std::mutex> lock(job_->mutex);
+    job_->stop = true;
+  }
+  job_->start.notify_all();
+  for (auto& w : workers_) {
+    if (w->thread.joinable()) w->thread.join();
+  }
+}
+
+auto column_formatter::format(dtoa_fun dtoa, int max_write,
+                              const double* values, size_t count,
+                              size_t chunk_size)
+    -> const std::vector<column_chunk>& {
+  chunk_size = std::max<size_t>(chunk_size, 1);
+  size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+  chunks_.assign(num_chunks, column_chunk{nullptr, 0, 0});
+
+  size_t n = workers_.size();
+  size_t block_size = std::max<size_t>(size_t(1) << 20,
+                                       chunk_size * max_length(max_write));
+  for (size_t i = 0; i < n; ++i) {
+    worker& w = *workers_[i];
+    w.begin = num_chunks * i / n;
+    w.end = num_chunks * (i + 1) / n;
+    w.steals = 0;
+    if (w.block_size != block_size) {
+      w.blocks.clear();
+      w.block_size = block_size;
+    }
+    w.block = 0;
+    w.used = 0;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(job_->mutex);
+    job_->dtoa = dtoa;
+    job_->max_length = max_length(max_write);
+    job_->values = values;
+    job_->count = count;
+    job_->chunk_size = chunk_size;
+    job_->pending = int(n) - 1;
+    ++job_->generation;
+  }
+  job_->start.notify_all();
+  run(int(n) - 1);
+  {
+    std::unique_lock<std::mutex> lock(job_->mutex);
+    job_->done.wait(lock, [this] { return job_->pending == 0; });
+  }
+
+  size_ = 0;
+  for (column_chunk& c : chunks_) {
+    c.offset = size_;
+    size_ += c.size;
+  }
+  return chunks_;
+}
+
+auto column_formatter::steals() const -> size_t {
+  size_t total = 0;
+  for (const auto& w : workers_) total += w->steals;
+  return total;
+}
+
+void column_formatter::run(int index) {
+  size_t chunk = 0;
+  while (take(index, chunk)) convert(index, chunk);
+}
+
+// Takes the next chunk of this thread or steals from the others.
+auto column_formatter::take(int index, size_t& chunk) -> bool {
+  worker& self = *workers_[index];
+  {
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (self.begin < self.end) {
+      chunk = self.begin++;
+      return true;
+    }
+  }
+  int n = int(workers_.size());
+  for (int i = 1; i < n; ++i) {
+    worker& victim = *workers_[(index + i) % n];
+    size_t begin = 0, end = 0;
+    {
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      size_t remaining = victim.end - victim.begin;
+      if (remaining == 0) continue;
+      end = victim.end;
+      begin = end - (remaining + 1) / 2;
+      victim.end = begin;
+    }
+    // The victim's lock is released first so that two threads stealing
+    // from each other can't deadlock.
+    {
+      std::lock_guard<std::mutex> lock(self.mutex);
+      self.begin = begin + 1;
+      self.end = end;
+      ++self.steals;
+    }
+    chunk = begin;
+    return true;
+  }
+  return false;
+}
+
+void column_formatter::convert(int index, size_t chunk) {
+  worker& w = *workers_[index];
+  size_t first = chunk * job_->chunk_size;
+  size_t last = std::min(first + job_->chunk_size, job_->count);
+  if (w.used + (last - first) * job_->max_length > w.block_size) {
+    ++w.block;
+    w.used = 0;
+  }
+  if (w.block == w.blocks.size())
+    w.blocks.emplace_back(new char[w.block_size]);
+
+  char* start = w.blocks[w.block].get() + w.used;
+  char* p = start;
+  dtoa_fun dtoa = job_->dtoa;
+  const double* values = job_->values;
+  for (size_t i = first; i < last; ++i) {
+    p = dtoa(values[i], p);
+    *p++ = separator_;
+  }
+  w.used += p - start;
+  chunks_[chunk] = column_chunk{start, size_t(p - start), 0};
+}
+
+void column_formatter::worker_loop(int index) {
+  unsigned seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(job_->mutex);
+      job_->start.wait(
+          lock, [&] { return job_->stop || job_->generation != seen; });
+      if (job_->stop) return;
+      seen = job_->generation;
+    }
+    run(index);
+    {
+      std::lock_guard<std::mutex> lock(job_->mutex);
+      if (--job_->pending == 0) job_->done.notify_one();
+    }
+  }
+}
@@ -0,0 +1,78 @@
+// Parallel formatting of a column of doubles with a registered dtoa_fun.
+//
+// The input is split into chunks of `chunk_size` values. Each thread starts
+// with a contiguous range of chunks and, once it runs out, steals the upper
+// half of the remaining range of another thread. Chunks are converted
+// straight into the arena of the thread that runs them, and a prefix sum over
+// the chunk sizes gives each chunk its offset in the output. The result is
+// the ordered list of chunk spans in the arenas, ready for e.g. writev, so
+// the output is never copied after conversion.
+
+#ifndef COLUMN_FORMATTER_H_
+#define COLUMN_FORMATTER_H_
+
+#include <stddef.h>  // size_t
+
+#include <memory>
+#include <vector>
+
+#include "benchmark.h"  // dtoa_fun
+
+struct column_chunk {
+  const char* data;
+  size_t size;
+  size_t offset;  // in the concatenated output
+};
+
+class column_formatter {
+ public:
+  // Bytes stored per value by methods that don't declare a max_write.
+  static constexpr size_t default_max_write = 32;
+
+  // Arena space reserved per value: the bytes `dtoa` may store from the
+  // output pointer, `max_write` or the default if 0, and the separator.
+  static constexpr auto max_length(int max_write) -> size_t {
+    return (max_write > 0 ? size_t(max_write) : default_max_write) + 1;
+  }
+
+  // Starts num_threads - 1 worker threads; the calling thread is the last
+  // one. Workers are pinned to CPUs round-robin if `pin` is set.
+  explicit column_formatter(int num_threads, bool pin = false,
+                            char separator = '\n');
+  ~column_formatter();
+
+  column_formatter(const column_formatter&) = delete;
+  void operator=(const column_formatter&) = delete;
+
+  // Formats values[0, count), each followed by the separator. `max_write` is
+  // the method's declared bound, 0 if none. The result is valid until the
+  // next call.
+  auto format(dtoa_fun dtoa, int max_write, const double* values,
+              size_t count, size_t chunk_size)
+      -> const std::vector<column_chunk>&;
+
+  auto num_threads() const -> int { return int(workers_.size()); }
+
+  // Total output size of the last call.
+  auto size() const -> size_t { return size_; }
+
+  // Number of successful steals in the last call.
+  auto steals() const -> size_t;
+
+ private:
+  struct worker;
+  struct job;
+
+  void run(int index);
+  auto take(int index, size_t& chunk) -> bool;
+  void convert(int index, size_t chunk);
+  void worker_loop(int index);
+
+  std::vector<std::unique_ptr<worker>> workers_;
+  std::unique_ptr<job> job_;
+  std::vector<column_chunk> chunks_;
+  size_t size_ = 0;
+  char separator_;
+};
+
+#endif  // COLUMN_FORMATTER_H_
@@ -0,0 +1,241 @@
+// Scaling test for the parallel column formatter (column-formatter.h).
+//
+// Formats a column of doubles with each method on 1, 2, 4, ... threads up to
+// the number of CPUs, for several chunk sizes, and reports throughput and
+// the speedup over one thread. Two inputs are used: the mixed pool of
+// dtoa-benchmark (1.7M doubles, uniform over 1-17 digits, shuffled) and a
+// large column made of copies of it, 1GB of doubles by default. The output
+// for the mixed pool is checked against a sequential conversion.
+//
+// Usage: ./column-scaling [--threads=1,2,...] [--chunks=1024,16384,...]
+//                         [--gb=<large input size>] [--runs=<n>] [method]
+//
+// The large input takes --gb of memory and its output about 3x as much.
+
+#include "column-formatter.h"
+#include "tool-methods.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// The mixed pool of dtoa-benchmark: 100'000 values per digit count, from the
+// same generator, shuffled with the same seed.
+static auto make_mixed_pool() -> std::vector<double> {
+  constexpr int max_digits = 17;
+  constexpr int num_doubles_per_digit = 100'000;
+  unsigned seed = 0;
+  auto next = [&]() {
+    seed = 214013 * seed + 2531011;
+    return seed;
+  };
+  std::vector<double> pool;
+  pool.reserve(max_digits * num_doubles_per_digit);
+  for (int digit = 1; digit <= max_digits; ++digit) {
+    for (int i = 0; i < num_doubles_per_digit; ++i) {
+      double d = 0;
+      do {
+        uint64_t bits = uint64_t(next()) << 32;
+        bits |= next();
+        memcpy(&d, &bits, sizeof(d));
+      } while (isnan(d) || isinf(d));
+      char buffer[64];
+      snprintf(buffer, sizeof(buffer), "%.*g", digit, d);
+      pool.push_back(strtod(buffer, nullptr));
+    }
+  }
+  std::shuffle(pool.begin(), pool.end(), std::mt19937(0));
+  return pool;
+}
+
+static auto parse_list(std::string_view s) -> std::vector<size_t> {
+  std::vector<size_t> values;
+  std::string str(s);
+  for (const char* p = str.c_str(); *p;) {
+    char* end = nullptr;
+    size_t value = strtoull(p, &end, 10);
+    if (end == p) break;
+    if (value > 0) values.push_back(value);
+    p = *end == ',' ? end + 1 : end;
+  }
+  return values;
+}
+
+// Checks the chunks of `formatter` against a sequential conversion of
+// values[0, count).
+static auto check(const column_formatter& formatter,
+                  const std::vector<column_chunk>& chunks, const method& m,
+                  const double* values, size_t count, size_t chunk_size)
+    -> bool {
+  size_t offset = 0;
+  std::vector<char> expected(column_formatter::max_length(m.max_write) * 64);
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    size_t first = c * chunk_size;
+    size_t last = std::min(first + chunk_size, count);
+    if (chunks[c].offset != offset) return false;
+    // Compare in batches of 64 values.
+    size_t pos = 0;
+    for (size_t i = first; i < last; i += 64) {
+      char* p = expected.data();
+      for (size_t j = i; j < std::min(i + 64, last); ++j) {
+        p = m.dtoa(values[j], p);
+        *p++ = '\n';
+      }
+      size_t size = p - expected.data();
+      if (pos + size > chunks[c].size ||
+          memcmp(chunks[c].data + pos, expected.data(), size) != 0) {
+        return false;
+      }
+      pos += size;
+    }
+    if (pos != chunks[c].size) return false;
+    offset += pos;
+  }
+  return offset == formatter.size();
+}
+
+struct run_result {
+  double seconds;
+  size_t steals;
+  bool ok;
+};
+
+static auto measure(column_formatter& formatter, const method& m,
+                    const std::vector<double>& values, size_t chunk_size,
+                    int runs, bool verify) -> run_result {
+  run_result best = {1e300, 0, true};
+  for (int r = 0; r < runs; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    const auto& chunks = formatter.format(m.dtoa, m.max_write, values.data(),
+                                          values.size(), chunk_size);
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    if (seconds < best.seconds) {
+      best.seconds = seconds;
+      best.steals = formatter.steals();
+    }
+    if (verify && r == 0) {
+      best.ok &= check(formatter, chunks, m, values.data(), values.size(),
+                       chunk_size);
+    }
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  std::vector<size_t> threads;
+  std::vector<size_t> chunk_sizes = {1024, 16384, 262144};
+  double gb = 1;
+  int runs = 3;
+  const char* filter = nullptr;
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    if (arg.starts_with("--threads=")) {
+      threads = parse_list(arg.substr(strlen("--threads=")));
+    } else if (arg.starts_with("--chunks=")) {
+      chunk_sizes = parse_list(arg.substr(strlen("--chunks=")));
+    } else if (arg.starts_with("--gb=")) {
+      gb = atof(argv[i] + strlen("--gb="));
+    } else if (arg.starts_with("--runs=")) {
+      runs = std::max(atoi(argv[i] + strlen("--runs=")), 1);
+    } else {
+      filter = argv[i];
+    }
+  }
+  int num_cpus = std::max(int(std::thread::hardware_concurrency()), 1);
+  if (threads.empty()) {
+    for (int t = 1; t < num_cpus; t *= 2) threads.push_back(t);
+    threads.push_back(num_cpus);
+  }
+  if (chunk_sizes.empty()) {
+    fprintf(stderr, "error: no chunk sizes\n");
+    return 1;
+  }
+
+  std::vector<double> mixed = make_mixed_pool();
+  std::vector<double> large;
+  size_t large_count = size_t(gb * 1e9) / sizeof(double);
+  large.reserve(large_count);
+  while (large.size() < large_count) {
+    size_t n = std::min(mixed.size(), large_count - large.size());
+    large.insert(large.end(), mixed.begin(), mixed.begin() + n);
+  }
+
+  struct dataset {
+    const char* name;
+    const std::vector<double>* values;
+    int runs;
+  };
+  std::vector<dataset> datasets = {{"mixed", &mixed, runs}};
+  if (!large.empty()) datasets.push_back({"large", &large, 1});
+
+  std::sort(methods.begin(), methods.end(),
+            [](const method& a, const method& b) { return a.name < b.name; });
+
+  int name_width = 6;
+  for (const auto& m : methods) {
+    int len = static_cast<int>(m.name.size());
+    if (len > name_width) name_width = len;
+  }
+  name_width += 2;
+
+  printf("Column formatter scaling (%d CPUs, mixed: %zu doubles, "
+         "large: %.2f GB of doubles)\n\n",
+         num_cpus, mixed.size(), large.size() * sizeof(double) / 1e9);
+  printf("%-*s %-6s %7s", name_width, "Method", "Data", "Chunk");
+  for (size_t t : threads) printf(" %7zuthr", t);
+  printf(" %8s %7s\n", "Speedup", "Steals");
+  printf("%-*s %-6s %7s", name_width, "------", "----", "-------");
+  for (size_t i = 0; i < threads.size(); ++i) printf(" %10s", "----------");
+  printf(" %8s %7s\n", "--------", "-------");
+
+  bool failed = false;
+  for (const auto& m : methods) {
+    if (m.name == "null" || m.name == "ostringstream" || m.name == "sprintf")
+      continue;
+    if (filter && m.name != filter) continue;
+
+    for (const dataset& data : datasets) {
+      for (size_t chunk_size : chunk_sizes) {
+        printf("%-*s %-6s %7zu", name_width, m.name.c_str(), data.name,
+               chunk_size);
+        fflush(stdout);
+        double first = 0, last = 0;
+        size_t steals = 0;
+        for (size_t t : threads) {
+          // A new formatter each time so that only one set of arenas is
+          // alive; the first run includes faulting them in.
+          column_formatter formatter(int(t), true);
+          run_result r = measure(formatter, m, *data.values, chunk_size,
+                                 data.runs, data.values == &mixed);
+          if (!r.ok) {
+            printf(" error: output differs from sequential conversion");
+            failed = true;
+            break;
+          }
+          double rate = data.values->size() / r.seconds / 1e6;
+          if (first == 0) first = rate;
+          last = rate;
+          steals = r.steals;
+          printf(" %7.1fM/s", rate);
+          fflush(stdout);
+        }
+        printf(" %7.2fx %7zu\n", last / first, steals);
+      }
+    }
+  }
+
+  printf("\nM/s = million doubles per second; speedup of the most threads "
+         "over one; steals in the fastest run with the most threads\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+// Compile-time shortest double-to-string conversion.
+//
+// Produces the same output as zmij::write (shortest round-trip digits,
+// fixed notation for decimal exponents in [-4, 15], exponential otherwise)
+// but is usable in constant expressions, so constant doubles embedded in
+// generated text can be rendered by the compiler:
+//
+//   constexpr auto s = consteval_dtoa::dtoa(6.62607015e-34);
+//   static_assert(std::string_view(s) == "6.62607015e-34");
+
+#ifndef CONSTEVAL_DTOA_H_
+#define CONSTEVAL_DTOA_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint64_t
+
+#include <bit>  // std::bit_cast
+#include <string_view>
+
+#include "dragonbox/dragonbox.h"
+
+namespace consteval_dtoa {
+
+// A fixed-size result; large enough for "-1.2345678901234567e-308".
+struct dtoa_string {
+  char data[32] = {};
+  size_t size = 0;
+
+  constexpr auto begin() const noexcept -> const char* { return data; }
+  constexpr auto end() const noexcept -> const char* { return data + size; }
+  constexpr operator std::string_view() const noexcept { return {data, size}; }
+};
+
+namespace detail {
+
+constexpr int min_fixed_exp = -4;
+constexpr int max_fixed_exp = 15;
+
+constexpr auto count_digits(uint64_t n) noexcept -> int {
+  int count = 1;
+  for (; n >= 10; n /= 10) ++count;
+  return count;
+}
+
+constexpr void append(dtoa_string& s, char c) noexcept { s.data[s.size++] = c; }
+
+constexpr void append(dtoa_string& s, std::string_view str) noexcept {
+  for (char c : str) append(s, c);
+}
+
+// Writes the digits of `sig`, which has `num_digits` digits, to `out`.
+constexpr void write_digits(char* out, uint64_t sig, int num_digits) noexcept {
+  for (int i = num_digits - 1; i >= 0; --i) {
+    out[i] = char('0' + sig % 10);
+    sig /= 10;
+  }
+}
+
+}  // namespace detail
+
+// Converts `value` into the shortest correctly rounded decimal representation.
+// Can be evaluated both at compile time and at run time.
+constexpr auto to_string(double value) noexcept -> dtoa_string {
+  using namespace detail;
+  dtoa_string result;
+  auto bits = std::bit_cast<uint64_t>(value);
+  if (bits >> 63) append(result, '-');
+  uint64_t bin_exp = (bits >> 52) & 0x7ff;
+  uint64_t bin_sig = bits & ((uint64_t(1) << 52) - 1);
+  if (bin_exp == 0x7ff) {
+    append(result, bin_sig == 0 ? "inf" : "nan");
+    return result;
+  }
+  if (bin_exp == 0 && bin_sig == 0) {
+    append(result, '0');
+    return result;
+  }
+
+  auto dec =
+      jkj::dragonbox::to_decimal(value, jkj::dragonbox::policy::sign::ignore);
+  uint64_t sig = dec.significand;
+  int num_digits = count_digits(sig);
+  int dec_exp = dec.exponent + num_digits - 1;  // Exponent of the first digit.
+
+  char digits[20] = {};
+  write_digits(digits, sig, num_digits);
+  auto str = std::string_view(digits, size_t(num_digits));
+
+  if (dec_exp >= min_fixed_exp && dec_exp <= max_fixed_exp) {
+    if (dec_exp < 0) {
+      append(result, "0.");
+      for (int i = -1; i > dec_exp; --i) append(result, '0');
+      append(result, str);
+    } else if (num_digits <= dec_exp + 1) {
+      append(result, str);
+      for (int i = num_digits; i <= dec_exp; ++i) append(result, '0');
+    } else {
+      append(result, str.substr(0, size_t(dec_exp + 1)));
+      append(result, '.');
+      append(result, str.substr(size_t(dec_exp + 1)));
+    }
+    return result;
+  }
+
+  append(result, str[0]);
+  if (num_digits > 1) {
+    append(result, '.');
+    append(result, str.substr(1));
+  }
+  append(result, dec_exp < 0 ? "e-" : "e+");
+  int abs_exp = dec_exp < 0 ? -dec_exp : dec_exp;
+  if (abs_exp >= 100) append(result, char('0' + abs_exp / 100));
+  append(result, char('0' + abs_exp / 10 % 10));
+  append(result, char('0' + abs_exp % 10));
+  return result;
+}
+
+// Converts `value` into the shortest correctly rounded decimal representation
+// at compile time.
+consteval auto dtoa(double value) noexcept -> dtoa_string {
+  return to_string(value);
+}
+
+}  // namespace consteval_dtoa
+
+#endif  // CONSTEVAL_DTOA_H_
@@ -0,0 +1,38 @@
+// Compile-time conversion (consteval-dtoa.h) evaluated at run time. Verified
+// byte-for-byte against zmij, whose output format it reproduces.
+
+#include "consteval-dtoa.h"
+
+#include <string.h>
+
+#include <limits>
+
+#include "benchmark.h"
+
+using consteval_dtoa::dtoa;
+using sv = std::string_view;
+
+static_assert(sv(dtoa(0)) == "0");
+static_assert(sv(dtoa(-0.0)) == "-0");
+static_assert(sv(dtoa(0.1)) == "0.1");
+static_assert(sv(dtoa(1.2345)) == "1.2345");
+static_assert(sv(dtoa(1.0 / 3.0)) == "0.3333333333333333");
+static_assert(sv(dtoa(0.0001)) == "0.0001");
+static_assert(sv(dtoa(0.00001)) == "1e-05");
+static_assert(sv(dtoa(1e15)) == "1000000000000000");
+static_assert(sv(dtoa(1e16)) == "1e+16");
+static_assert(sv(dtoa(6.62607015e-34)) == "6.62607015e-34");
+static_assert(sv(dtoa(std::numeric_limits<double>::max())) ==
+              "1.7976931348623157e+308");
+static_assert(sv(dtoa(std::numeric_limits<double>::denorm_min())) ==
+              "5e-324");
+static_assert(sv(dtoa(std::numeric_limits<double>::infinity())) == "inf");
+
+static register_method _(
+    "consteval",
+    [](double value, char* buffer) -> char* {
+      auto s = consteval_dtoa::to_string(value);
+      memcpy(buffer, s.data, sizeof(s.data));
+      return buffer + s.size;
+    },
+    "zmij", 32);
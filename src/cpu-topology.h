@@ -0,0 +1,55 @@
+// CPU topology helpers for the Linux-only multi-threaded benchmarks.
+
+#ifndef CPU_TOPOLOGY_H_
+#define CPU_TOPOLOGY_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>   // fopen, fgets
+#include <stdlib.h>  // strtol
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parses a CPU list in the sysfs format, e.g. "0-3,8,10-11".
+inline auto parse_cpu_list(std::string_view list) -> std::vector<int> {
+  std::vector<int> cpus;
+  std::string s(list);
+  const char* p = s.c_str();
+  while (*p) {
+    char* end = nullptr;
+    long first = strtol(p, &end, 10);
+    if (end == p) break;
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      last = strtol(p + 1, &end, 10);
+      p = end;
+    }
+    for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(int(cpu));
+    if (*p != ',') break;
+    ++p;
+  }
+  return cpus;
+}
+
+// Reads a sysfs CPU list file; returns an empty list if it doesn't exist.
+inline auto read_cpu_list(const std::string& path) -> std::vector<int> {
+  FILE* f = fopen(path.c_str(), "r");
+  if (!f) return {};
+  char line[4096] = {};
+  bool ok = fgets(line, sizeof(line), f) != nullptr;
+  fclose(f);
+  return ok ? parse_cpu_list(line) : std::vector<int>();
+}
+
+// Pins the calling thread to `cpu`. Returns false on failure.
+inline auto pin_to_cpu(int cpu) -> bool {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#endif  // CPU_TOPOLOGY_H_
@@ -0,0 +1,150 @@
+#include "dataset-cache.h"
+
+#include <stdio.h>   // fopen, fwrite, rename
+#include <stdlib.h>  // getenv
+#include <string.h>  // memcmp, memcpy
+
+#include <map>
+#include <memory>  // std::unique_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#  include <fcntl.h>     // open
+#  include <sys/mman.h>  // mmap
+#  include <sys/stat.h>  // fstat, mkdir
+#  include <unistd.h>    // close, getpid
+#endif
+
+namespace {
+
+// File layout: header, key padded to a multiple of 8 bytes, data.
+struct file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_size;
+  uint64_t count;
+};
+
+constexpr char magic[8] = {'D', 'T', 'O', 'A', 'D', 'A', 'T', 'A'};
+
+auto data_offset(size_t key_size) -> size_t {
+  return sizeof(file_header) + (key_size + 7) / 8 * 8;
+}
+
+std::mutex mutex;
+bool enabled = true;
+// Datasets that are generated rather than mapped, by key.
+std::map<std::string, std::unique_ptr<double[]>> generated;
+std::map<std::string, const double*> mapped;
+
+auto cache_dir() -> std::string {
+  if (const char* dir = getenv("DTOA_DATASET_CACHE")) return dir;
+  if (const char* dir = getenv("XDG_CACHE_HOME"); dir && *dir)
+    return std::string(dir) + "/dtoa-benchmark";
+  if (const char* home = getenv("HOME"); home && *home)
+    return std::string(home) + "/.cache/dtoa-benchmark";
+  return "";
+}
+
+#ifndef _WIN32
+// Maps `path` if it holds `count` values of `key` in the current format.
+auto map_file(const std::string& path, const std::string& key, size_t count)
+    -> const double* {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return nullptr;
+  size_t size = data_offset(key.size()) + count * sizeof(double);
+  struct stat st = {};
+  void* p = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && size_t(st.st_size) == size)
+    p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) return nullptr;
+  auto bytes = static_cast<const char*>(p);
+  file_header header;
+  memcpy(&header, bytes, sizeof(header));
+  if (memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      header.version != dataset_cache_version ||
+      header.key_size != key.size() || header.count != count ||
+      memcmp(bytes + sizeof(header), key.data(), key.size()) != 0) {
+    munmap(p, size);
+    return nullptr;
+  }
+  return reinterpret_cast<const double*>(bytes + data_offset(key.size()));
+}
+
+// Creates `dir` and its missing parents.
+void make_dirs(const std::string& dir) {
+  for (size_t pos = dir.find('/', 1); pos != std::string::npos;
+       pos = dir.find('/', pos + 1)) {
+    mkdir(dir.substr(0, pos).c_str(), 0755);
+  }
+  mkdir(dir.c_str(), 0755);
+}
+
+// Writes the dataset to a temporary file and renames it into place, so that
+// concurrent runs never map a partially written file. Failures only lose
+// the cache entry.
+void write_file(const std::string& dir, const std::string& path,
+                const std::string& key, const double* data, size_t count) {
+  make_dirs(dir);
+  std::string tmp = path + ".tmp." + std::to_string(getpid()) + "." +
+                    std::to_string(std::hash<std::thread::id>()(
+                        std::this_thread::get_id()));
+  FILE* f = fopen(tmp.c_str(), "wb");
+  if (!f) return;
+  file_header header = {};
+  memcpy(header.magic, magic, sizeof(magic));
+  header.version = dataset_cache_version;
+  header.key_size = uint32_t(key.size());
+  header.count = count;
+  std::vector<char> prefix(data_offset(key.size()));
+  memcpy(prefix.data(), &header, sizeof(header));
+  memcpy(prefix.data() + sizeof(header), key.data(), key.size());
+  bool ok = fwrite(prefix.data(), prefix.size(), 1, f) == 1 &&
+            fwrite(data, sizeof(double), count, f) == count;
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp.c_str(), path.c_str()) != 0) remove(tmp.c_str());
+}
+#endif
+
+}  // namespace
+
+auto get_cached_dataset(const std::string& key, size_t count,
+                        const std::function<void(double* data)>& generate)
+    -> const double* {
+  std::string dir;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto it = mapped.find(key); it != mapped.end()) return it->second;
+    if (auto it = generated.find(key); it != generated.end())
+      return it->second.get();
+    if (enabled) dir = cache_dir();
+  }
+#ifdef _WIN32
+  dir.clear();
+#else
+  std::string path = dir + "/" + key + ".bin";
+  if (!dir.empty()) {
+    if (const double* data = map_file(path, key, count)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      return mapped.emplace(key, data).first->second;
+    }
+  }
+#endif
+
+  auto data = std::unique_ptr<double[]>(new double[count]);
+  generate(data.get());
+#ifndef _WIN32
+  if (!dir.empty()) write_file(dir, path, key, data.get(), count);
+#endif
+  std::lock_guard<std::mutex> lock(mutex);
+  // Another thread may have generated the same dataset in the meantime.
+  return generated.emplace(key, std::move(data)).first->second.get();
+}
+
+void disable_dataset_cache() {
+  std::lock_guard<std::mutex> lock(mutex);
+  enabled = false;
+}
@@ -0,0 +1,36 @@
+// Persistent cache of generated benchmark datasets.
+//
+// Generating the datasets takes a noticeable part of the startup time since
+// every value is reduced to its digit count with snprintf and parsed back.
+// Instead, each dataset is stored once as <dir>/<key>.bin and memory-mapped
+// read-only on later runs. <dir> is $DTOA_DATASET_CACHE if set, otherwise
+// $XDG_CACHE_HOME/dtoa-benchmark or ~/.cache/dtoa-benchmark.
+//
+// The key must encode every generator parameter including the seed, and
+// dataset_cache_version must be incremented whenever a generator changes its
+// output, so that stale files are never used.
+
+#ifndef DATASET_CACHE_H_
+#define DATASET_CACHE_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
+
+#include <functional>
+#include <string>
+
+constexpr uint32_t dataset_cache_version = 1;
+
+// Returns the `count` doubles of the dataset `key`, mapped from the cache if
+// it has a valid file for it and otherwise produced by `generate` and stored.
+// The data stays valid until exit. Thread-safe, so datasets can be generated
+// in parallel.
+auto get_cached_dataset(const std::string& key, size_t count,
+                        const std::function<void(double* data)>& generate)
+    -> const double*;
+
+// Makes get_cached_dataset generate every dataset without reading or writing
+// files.
+void disable_dataset_cache();
+
+#endif  // DATASET_CACHE_H_
@@ -7,4 +7,4 @@ static register_method _("double-conversion", [](double value, char* buffer) ->
   StringBuilder sb(buffer, 26);
   DoubleToStringConverter::EcmaScriptConverter().ToShortest(value, &sb);
   return buffer + sb.position();
-});
+}, nullptr, 26);
@@ -0,0 +1,41 @@
+// Generated by table-profile; do not edit.
+//
+// Hot subset of the dragonbox binary64 full cache: k in [8, 27]
+// covers 100% of the cache accesses for the profile dataset (1-17 digits, 1e-9..1e9).
+
+#ifndef DRAGONBOX_HOT_CACHE_H_
+#define DRAGONBOX_HOT_CACHE_H_
+
+#include <stdint.h>
+
+namespace dragonbox_hot {
+
+constexpr int min_k = 8;
+constexpr int max_k = 27;
+
+alignas(64) constexpr uint64_t cache[max_k - min_k + 1][2] = {
+    {0xbebc200000000000, 0x0000000000000000},  // k = 8
+    {0xee6b280000000000, 0x0000000000000000},  // k = 9
+    {0x9502f90000000000, 0x0000000000000000},  // k = 10
+    {0xba43b74000000000, 0x0000000000000000},  // k = 11
+    {0xe8d4a51000000000, 0x0000000000000000},  // k = 12
+    {0x9184e72a00000000, 0x0000000000000000},  // k = 13
+    {0xb5e620f480000000, 0x0000000000000000},  // k = 14
+    {0xe35fa931a0000000, 0x0000000000000000},  // k = 15
+    {0x8e1bc9bf04000000, 0x0000000000000000},  // k = 16
+    {0xb1a2bc2ec5000000, 0x0000000000000000},  // k = 17
+    {0xde0b6b3a76400000, 0x0000000000000000},  // k = 18
+    {0x8ac7230489e80000, 0x0000000000000000},  // k = 19
+    {0xad78ebc5ac620000, 0x0000000000000000},  // k = 20
+    {0xd8d726b7177a8000, 0x0000000000000000},  // k = 21
+    {0x878678326eac9000, 0x0000000000000000},  // k = 22
+    {0xa968163f0a57b400, 0x0000000000000000},  // k = 23
+    {0xd3c21bcecceda100, 0x0000000000000000},  // k = 24
+    {0x84595161401484a0, 0x0000000000000000},  // k = 25
+    {0xa56fa5b99019a5c8, 0x0000000000000000},  // k = 26
+    {0xcecb8f27f4200f3a, 0x0000000000000000},  // k = 27
+};
+
+}  // namespace dragonbox_hot
+
+#endif  // DRAGONBOX_HOT_CACHE_H_
@@ -0,0 +1,36 @@
+// dragonbox with a hot-subset cache: the entries of the full cache that the
+// profile dataset touches (see table-profile and profile-data.h) are kept in
+// a small line-aligned table, and the remaining exponents fall back to the
+// compressed cache, which recovers the same entries from ~0.6KB of tables.
+// Compare with dragonbox in cache-pressure / cache-contention --profile-data.
+
+#include "benchmark.h"
+#include "dragonbox-hot-cache.h"
+#include "dragonbox/dragonbox_to_chars.h"
+
+namespace {
+
+struct hot_cache {
+  using cache_policy = hot_cache;
+  template <class FloatFormat>
+  using cache_holder_type = jkj::dragonbox::compressed_cache_holder<FloatFormat>;
+
+  template <class FloatFormat, class ShiftAmountType, class DecimalExponentType>
+  static auto get_cache(DecimalExponentType k) noexcept ->
+      typename cache_holder_type<FloatFormat>::cache_entry_type {
+    using entry_type = typename cache_holder_type<FloatFormat>::cache_entry_type;
+    unsigned i = unsigned(k - dragonbox_hot::min_k);
+    if (i <= unsigned(dragonbox_hot::max_k - dragonbox_hot::min_k)) [[likely]]
+      return entry_type(dragonbox_hot::cache[i][0], dragonbox_hot::cache[i][1]);
+    return cache_holder_type<FloatFormat>::template get_cache<ShiftAmountType>(k);
+  }
+};
+
+}  // namespace
+
+static register_method _(
+    "dragonbox-hot",
+    [](double value, char* buffer) -> char* {
+      return jkj::dragonbox::to_chars_n(value, buffer, hot_cache());
+    },
+    "dragonbox", 24);
@@ -0,0 +1,38 @@
+// dragonbox with the full cache read through a pointer, so that
+// place_tables() can move it into a huge page (see table-placement.h).
+
+#include "benchmark.h"
+#include "dragonbox/dragonbox_to_chars.h"
+#include "table-placement.h"
+
+namespace {
+
+using cache_holder =
+    jkj::dragonbox::cache_holder<jkj::dragonbox::ieee754_binary64>;
+using cache_entry = cache_holder::cache_entry_type;
+
+const void* cache = cache_holder::cache.data_;
+
+relocatable_table table("dragonbox-relocatable", "dragonbox full cache",
+                        cache_holder::cache.data_, sizeof(cache_holder::cache),
+                        &cache);
+
+struct relocatable_cache {
+  using cache_policy = relocatable_cache;
+  template <class FloatFormat>
+  using cache_holder_type = jkj::dragonbox::cache_holder<FloatFormat>;
+
+  template <class FloatFormat, class ShiftAmountType, class DecimalExponentType>
+  static auto get_cache(DecimalExponentType k) noexcept -> cache_entry {
+    return static_cast<const cache_entry*>(cache)[k - cache_holder::min_k];
+  }
+};
+
+}  // namespace
+
+static register_method _(
+    "dragonbox-relocatable",
+    [](double value, char* buffer) -> char* {
+      return jkj::dragonbox::to_chars_n(value, buffer, relocatable_cache());
+    },
+    "dragonbox", 24);
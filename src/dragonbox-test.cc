@@ -1,7 +1,21 @@
+#include <cmath>
+
 #include "benchmark.h"
 #include "dragonbox/dragonbox_to_chars.h"
+#include "dtoa-length.h"
 
 static register_method _("dragonbox", [](double value, char* buffer) -> char* {
   return jkj::dragonbox::to_chars_n(value, buffer,
                                     jkj::dragonbox::policy::cache::full);
+}, nullptr, 24, [](double value) -> size_t {
+  bool negative = std::signbit(value);
+  if (!std::isfinite(value)) return std::isnan(value) ? 3 : negative + 8;
+  if (value == 0) return negative + 3;  // 0E0
+  // The significand comes without trailing zeros.
+  auto dec = jkj::dragonbox::to_decimal(value,
+                                        jkj::dragonbox::policy::sign::ignore,
+                                        jkj::dragonbox::policy::cache::full);
+  int num_digits = dtoa_length::count_digits(dec.significand);
+  return dtoa_length::ryu_length(negative, num_digits,
+                                 dec.exponent + num_digits - 1);
 });
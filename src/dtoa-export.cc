@@ -0,0 +1,533 @@
+// End-to-end export test for dtoa implementations.
+//
+// Exporters convert hundreds of MB of doubles to text and write them to a
+// file, and the conversion is only part of the cost. This tool converts a
+// memory-mapped float64 input with each method, one value per line, and
+// writes the text to a file in one of four ways:
+//
+//   write    - format into a 1MB buffer, write(2) it when full
+//   writev   - format into 16 64KB buffers, write all of them with writev(2)
+//   mmap     - size the output file up front, map it and format in place
+//   io_uring - format into 8 1MB buffers that are written asynchronously
+//              with IORING_OP_WRITE (raw syscalls, no liburing)
+//
+// It reports end-to-end throughput of the text output and how the time
+// splits between conversion and I/O. For io_uring the I/O time is the time
+// spent submitting and waiting for buffers, since the writes overlap with
+// the conversion.
+//
+// Usage: ./dtoa-export [--io=write|writev|mmap|io_uring|all]
+//                      [--input=<float64 file>] [--count=<doubles>]
+//                      [--dir=<output directory>] [--fsync] [method]
+//
+// Without --input, --count (default 8M) random doubles with 1-17 significant
+// digits are written to a temporary file in the output directory and mapped.
+// The output directory defaults to $TMPDIR or /tmp; point --dir at a disk
+// mount and add --fsync to include writeback.
+
+#include "tool-methods.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Upper bound on the output of one value including the newline; the longest
+// output of any method, yy and double-conversion, is 25 characters.
+static constexpr size_t MAX_LINE = 26;
+
+// Bytes a method may store from the output pointer on for one value,
+// including scratch bytes past its output and the newline. Methods without a
+// declared max_write get a generous bound.
+static size_t max_store(const method& m) {
+  return (m.max_write > 0 ? size_t(m.max_write) : 64) + 1;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+static double seconds_since(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+struct export_times {
+  double convert = 0;  // seconds
+  double io = 0;       // seconds
+  size_t bytes = 0;    // text output
+  bool ok = true;
+  const char* error = "I/O failed";
+};
+
+// Converts values from `next` on into `buffer` until fewer than max_store(m)
+// bytes are left or the input is exhausted. Returns the number of bytes
+// written.
+static size_t fill(const method& m, const double* values, size_t count,
+                   size_t& next, char* buffer, size_t capacity,
+                   export_times& t) {
+  auto start = clock_type::now();
+  dtoa_fun dtoa = m.dtoa;
+  char* p = buffer;
+  char* limit = buffer + capacity - max_store(m);
+  while (next < count && p <= limit) {
+    p = dtoa(values[next++], p);
+    *p++ = '\n';
+  }
+  t.convert += seconds_since(start);
+  return p - buffer;
+}
+
+static bool write_all(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+static void export_write(int fd, const method& m, const double* values,
+                         size_t count, export_times& t) {
+  constexpr size_t BUFFER_SIZE = 1 << 20;
+  std::vector<char> buffer(BUFFER_SIZE);
+  for (size_t next = 0; next < count;) {
+    size_t size = fill(m, values, count, next, buffer.data(), BUFFER_SIZE,
+                       t);
+    auto start = clock_type::now();
+    t.ok &= write_all(fd, buffer.data(), size);
+    t.io += seconds_since(start);
+    t.bytes += size;
+  }
+}
+
+static void export_writev(int fd, const method& m, const double* values,
+                          size_t count, export_times& t) {
+  constexpr size_t NUM_BUFFERS = 16, BUFFER_SIZE = 64 << 10;
+  std::vector<char> buffers(NUM_BUFFERS * BUFFER_SIZE);
+  iovec iov[NUM_BUFFERS];
+  for (size_t next = 0; next < count;) {
+    int n = 0;
+    for (; n < int(NUM_BUFFERS) && next < count; n++) {
+      char* buffer = buffers.data() + n * BUFFER_SIZE;
+      size_t size = fill(m, values, count, next, buffer, BUFFER_SIZE, t);
+      iov[n] = {buffer, size};
+      t.bytes += size;
+    }
+    auto start = clock_type::now();
+    // Resume after short writes.
+    for (iovec* v = iov; n > 0;) {
+      ssize_t written = writev(fd, v, n);
+      if (written <= 0) {
+        t.ok = false;
+        break;
+      }
+      while (n > 0 && size_t(written) >= v->iov_len) {
+        written -= v->iov_len;
+        ++v, --n;
+      }
+      if (n > 0) {
+        v->iov_base = static_cast<char*>(v->iov_base) + written;
+        v->iov_len -= written;
+      }
+    }
+    t.io += seconds_since(start);
+  }
+}
+
+static void export_mmap(int fd, const method& m, const double* values,
+                        size_t count, export_times& t) {
+  // Map an upper bound and trim the file afterwards. MAP_POPULATE moves the
+  // page-cache allocation out of the conversion loop into the I/O time.
+  size_t capacity = count * MAX_LINE + max_store(m);
+  auto start = clock_type::now();
+  void* map = MAP_FAILED;
+  if (ftruncate(fd, capacity) == 0) {
+    map = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, fd, 0);
+  }
+  t.io += seconds_since(start);
+  if (map == MAP_FAILED) {
+    t.ok = false;
+    return;
+  }
+  size_t next = 0;
+  t.bytes = fill(m, values, count, next, static_cast<char*>(map),
+                 capacity, t);
+  if (next < count) {
+    t.ok = false;
+    t.error = "output longer than MAX_LINE per value";
+  }
+  start = clock_type::now();
+  munmap(map, capacity);
+  t.ok &= ftruncate(fd, t.bytes) == 0;
+  t.io += seconds_since(start);
+}
+
+// A minimal io_uring: one submission and one completion queue mapped from
+// the kernel, driven with io_uring_setup(2) and io_uring_enter(2).
+class uring {
+ private:
+  int fd_ = -1;
+  void* sq_ring_ = MAP_FAILED;
+  void* cq_ring_ = MAP_FAILED;
+  size_t sq_ring_size_ = 0, cq_ring_size_ = 0, sqes_size_ = 0;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  io_uring_cqe* cqes_ = nullptr;
+
+  static auto offset(void* base, unsigned off) -> unsigned* {
+    return reinterpret_cast<unsigned*>(static_cast<char*>(base) + off);
+  }
+
+ public:
+  explicit uring(unsigned entries) {
+    io_uring_params params = {};
+    fd_ = int(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) return;
+    sq_ring_size_ =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) return;
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      cq_ring_ = sq_ring_;
+    } else {
+      cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+      if (cq_ring_ == MAP_FAILED) return;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+    sq_tail_ = offset(sq_ring_, params.sq_off.tail);
+    sq_mask_ = offset(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = offset(sq_ring_, params.sq_off.array);
+    cq_head_ = offset(cq_ring_, params.cq_off.head);
+    cq_tail_ = offset(cq_ring_, params.cq_off.tail);
+    cq_mask_ = offset(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cq_ring_) +
+                                            params.cq_off.cqes);
+  }
+
+  ~uring() {
+    if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+      munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_ != MAP_FAILED) munmap(sq_ring_, sq_ring_size_);
+    if (fd_ >= 0) close(fd_);
+  }
+
+  uring(const uring&) = delete;
+  void operator=(const uring&) = delete;
+
+  auto ok() const -> bool { return fd_ >= 0 && sqes_ != MAP_FAILED; }
+
+  // Submits a write of `size` bytes at `offset` in `fd`.
+  auto write(int fd, const char* data, unsigned size, uint64_t file_offset,
+             uint64_t user_data) -> bool {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = size;
+    sqe->off = file_offset;
+    sqe->user_data = user_data;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    return syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0) == 1;
+  }
+
+  // Waits for a completion and returns it in `user_data` and `result`.
+  auto wait(uint64_t& user_data, int& result) -> bool {
+    for (;;) {
+      unsigned head = *cq_head_;
+      if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+        user_data = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+      if (syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS,
+                  nullptr, 0) < 0) {
+        return false;
+      }
+    }
+  }
+};
+
+static void export_io_uring(int fd, const method& m, const double* values,
+                            size_t count, export_times& t) {
+  constexpr unsigned NUM_BUFFERS = 8;
+  constexpr size_t BUFFER_SIZE = 1 << 20;
+  uring ring(NUM_BUFFERS);
+  if (!ring.ok()) {
+    t.ok = false;
+    t.error = "io_uring unavailable";
+    return;
+  }
+  std::vector<char> buffers(NUM_BUFFERS * BUFFER_SIZE);
+  size_t sizes[NUM_BUFFERS] = {};
+  bool busy[NUM_BUFFERS] = {};
+  unsigned in_flight = 0;
+
+  // Waits for one write and checks that it was complete.
+  auto complete_one = [&]() {
+    uint64_t slot = 0;
+    int result = 0;
+    if (!ring.wait(slot, result) || result < 0 ||
+        size_t(result) != sizes[slot]) {
+      t.ok = false;
+      return false;
+    }
+    busy[slot] = false;
+    --in_flight;
+    return true;
+  };
+
+  uint64_t file_offset = 0;
+  for (size_t next = 0, slot = 0; next < count && t.ok;
+       slot = (slot + 1) % NUM_BUFFERS) {
+    auto start = clock_type::now();
+    while (busy[slot] && complete_one()) {}
+    t.io += seconds_since(start);
+    if (!t.ok) break;
+
+    char* buffer = buffers.data() + slot * BUFFER_SIZE;
+    sizes[slot] = fill(m, values, count, next, buffer, BUFFER_SIZE, t);
+
+    start = clock_type::now();
+    if (ring.write(fd, buffer, unsigned(sizes[slot]), file_offset, slot)) {
+      busy[slot] = true;
+      ++in_flight;
+    } else {
+      t.ok = false;
+    }
+    t.io += seconds_since(start);
+    file_offset += sizes[slot];
+    t.bytes += sizes[slot];
+  }
+  auto start = clock_type::now();
+  while (in_flight > 0 && complete_one()) {}
+  t.io += seconds_since(start);
+}
+
+struct io_method {
+  const char* name;
+  void (*run)(int fd, const method& m, const double* values, size_t count,
+              export_times& t);
+};
+
+static const io_method io_methods[] = {
+    {"write", export_write},
+    {"writev", export_writev},
+    {"mmap", export_mmap},
+    {"io_uring", export_io_uring},
+};
+
+// Writes `count` doubles with 1-17 significant digits, uniformly
+// distributed, and decimal exponents in [-30, 30] to `path`.
+static bool generate_input(const std::string& path, size_t count) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  uint64_t x = 0x9e3779b97f4a7c15ULL;
+  auto next = [&]() {
+    x ^= x << 13, x ^= x >> 7, x ^= x << 17;  // xorshift64
+    return x;
+  };
+  std::vector<double> chunk;
+  chunk.reserve(1 << 16);
+  for (size_t i = 0; i < count; i++) {
+    int digits = 1 + next() % 17;
+    uint64_t pow10 = 1;
+    for (int d = 1; d < digits; d++) pow10 *= 10;
+    uint64_t sig = pow10 + next() % (pow10 * 9);
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%llue%d", (unsigned long long)sig,
+             int(next() % 61) - 30);
+    chunk.push_back(strtod(buffer, nullptr));
+    if (chunk.size() == chunk.capacity() || i + 1 == count) {
+      if (fwrite(chunk.data(), sizeof(double), chunk.size(), f) !=
+          chunk.size()) {
+        fclose(f);
+        return false;
+      }
+      chunk.clear();
+    }
+  }
+  return fclose(f) == 0;
+}
+
+static auto fs_name(const std::string& dir) -> const char* {
+  struct statfs fs;
+  if (statfs(dir.c_str(), &fs) != 0) return "unknown";
+  return fs.f_type == 0x01021994 /* TMPFS_MAGIC */ ? "tmpfs" : "disk";
+}
+
+int main(int argc, char** argv) {
+  std::vector<const io_method*> active;
+  std::string input;
+  size_t count = 8 << 20;
+  const char* tmpdir = getenv("TMPDIR");
+  std::string dir = tmpdir && *tmpdir ? tmpdir : "/tmp";
+  bool sync = false;
+  const char* filter = nullptr;
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    if (arg.starts_with("--io=")) {
+      auto name = arg.substr(strlen("--io="));
+      bool found = false;
+      for (const io_method& io : io_methods) {
+        if (name == "all" || name == io.name) {
+          active.push_back(&io);
+          found = true;
+        }
+      }
+      if (!found) {
+        fprintf(stderr, "error: unknown I/O method '%.*s'\n",
+                int(name.size()), name.data());
+        return 1;
+      }
+    } else if (arg.starts_with("--input=")) {
+      input = arg.substr(strlen("--input="));
+    } else if (arg.starts_with("--count=")) {
+      count = strtoull(argv[i] + strlen("--count="), nullptr, 10);
+    } else if (arg.starts_with("--dir=")) {
+      dir = arg.substr(strlen("--dir="));
+    } else if (arg == "--fsync") {
+      sync = true;
+    } else {
+      filter = argv[i];
+    }
+  }
+  if (active.empty()) {
+    for (const io_method& io : io_methods) active.push_back(&io);
+  }
+
+  // Map the input. A generated input is unlinked right away; the mapping
+  // keeps it alive.
+  bool generated = input.empty();
+  if (generated) {
+    input = dir + "/dtoa-export-" + std::to_string(getpid()) + ".in";
+    if (!generate_input(input, count)) {
+      fprintf(stderr, "error: cannot write %s\n", input.c_str());
+      return 1;
+    }
+  }
+  int input_fd = open(input.c_str(), O_RDONLY);
+  struct stat st = {};
+  if (input_fd < 0 || fstat(input_fd, &st) != 0) {
+    fprintf(stderr, "error: cannot open %s\n", input.c_str());
+    return 1;
+  }
+  count = size_t(st.st_size) / sizeof(double);
+  if (count == 0) {
+    fprintf(stderr, "error: %s has no doubles\n", input.c_str());
+    return 1;
+  }
+  void* map = mmap(nullptr, count * sizeof(double), PROT_READ,
+                   MAP_PRIVATE | MAP_POPULATE, input_fd, 0);
+  close(input_fd);
+  if (generated) unlink(input.c_str());
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "error: cannot map %s\n", input.c_str());
+    return 1;
+  }
+  const double* values = static_cast<const double*>(map);
+
+  std::sort(methods.begin(), methods.end(),
+            [](const method& a, const method& b) { return a.name < b.name; });
+
+  int name_width = 6;
+  for (const auto& m : methods) {
+    int len = static_cast<int>(m.name.size());
+    if (len > name_width) name_width = len;
+  }
+  name_width += 2;
+
+  printf("Export test: %zu doubles (%.1f MB) to %s (%s)%s\n\n", count,
+         count * sizeof(double) / 1e6, dir.c_str(), fs_name(dir),
+         sync ? ", fsync" : "");
+  printf("%-*s %-8s %9s %8s %7s %8s %8s\n", name_width, "Method", "I/O",
+         "Output", "Total", "GB/s", "Convert", "I/O");
+  printf("%-*s %-8s %9s %8s %7s %8s %8s\n", name_width, "------", "---",
+         "---------", "--------", "-------", "--------", "--------");
+
+  std::string output = dir + "/dtoa-export-" + std::to_string(getpid()) +
+                       ".out";
+  bool failed = false;
+  for (const auto& m : methods) {
+    // The slow methods are only run when requested explicitly.
+    if (m.name == "null" ||
+        (!filter && (m.name == "ostringstream" || m.name == "sprintf")))
+      continue;
+    if (filter && m.name != filter) continue;
+
+    size_t expected_bytes = 0;
+    for (const io_method* io : active) {
+      printf("%-*s %-8s", name_width, m.name.c_str(), io->name);
+      fflush(stdout);
+
+      export_times t;
+      auto start = clock_type::now();
+      int fd = open(output.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        t.ok = false;
+        t.error = strerror(errno);
+      } else {
+        io->run(fd, m, values, count, t);
+        auto io_start = clock_type::now();
+        if (sync) t.ok &= fsync(fd) == 0;
+        t.ok &= fstat(fd, &st) == 0 && size_t(st.st_size) == t.bytes;
+        t.ok &= close(fd) == 0;
+        t.io += seconds_since(io_start);
+      }
+      double total = seconds_since(start);
+      unlink(output.c_str());
+
+      if (t.ok && expected_bytes != 0 && t.bytes != expected_bytes)
+        t.ok = false;
+      if (!t.ok) {
+        printf(" error: %s\n", t.error);
+        failed = true;
+        continue;
+      }
+      expected_bytes = t.bytes;
+      printf(" %7.1fMB %7.3fs %7.2f %7.0f%% %7.0f%%\n", t.bytes / 1e6, total,
+             t.bytes / total / 1e9, t.convert / total * 100,
+             t.io / total * 100);
+    }
+  }
+
+  printf("\nGB/s = text output per second including open and close; "
+         "Convert/I/O = share of the total\n");
+  munmap(map, count * sizeof(double));
+  return failed ? 1 : 0;
+}
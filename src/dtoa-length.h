@@ -0,0 +1,67 @@
+// Output lengths of the shortest representation in the formats of fmt and
+// Dragonbox, computed from the decimal significand and exponent without
+// generating digits. zmij-length.h builds zmij's on these.
+
+#ifndef DTOA_LENGTH_H_
+#define DTOA_LENGTH_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint64_t
+
+#include <bit>  // std::bit_width
+
+namespace dtoa_length {
+
+// Returns the number of decimal digits of n > 0.
+inline auto count_digits(uint64_t n) noexcept -> int {
+  static constexpr uint64_t pow10[] = {1,
+                                       10,
+                                       100,
+                                       1'000,
+                                       10'000,
+                                       100'000,
+                                       1'000'000,
+                                       10'000'000,
+                                       100'000'000,
+                                       1'000'000'000,
+                                       10'000'000'000,
+                                       100'000'000'000,
+                                       1'000'000'000'000,
+                                       10'000'000'000'000,
+                                       100'000'000'000'000,
+                                       1'000'000'000'000'000,
+                                       10'000'000'000'000'000,
+                                       100'000'000'000'000'000,
+                                       1'000'000'000'000'000'000,
+                                       10'000'000'000'000'000'000u};
+  // 1233 / 2**12 ~ log10(2), so t is floor(log10(n)) or one more.
+  int t = (std::bit_width(n) * 1233) >> 12;
+  return t + 1 - (n < pow10[t]);
+}
+
+// Length of fmt's shortest format ("{}") for a nonzero finite value with
+// `num_digits` significant digits d.ddd * 10**exp: fixed for exp in [-4, 16),
+// e.g. 0.001 or 1234.5, and d[.ddd]e+dd[d] otherwise.
+inline auto fmt_length(bool negative, int num_digits, int exp) noexcept
+    -> size_t {
+  size_t sign = negative;
+  if (exp >= -4 && exp < 16) {
+    if (exp < 0) return sign + 1 - exp + num_digits;  // 0.0ddd
+    return sign + (num_digits > exp + 1 ? num_digits + 1 : exp + 1);
+  }
+  int abs_exp = exp < 0 ? -exp : exp;
+  return sign + num_digits + (num_digits > 1) + (abs_exp >= 100 ? 5 : 4);
+}
+
+// Length of Ryu's and Dragonbox's format d[.ddd]E[-]x for a nonzero finite
+// value with `num_digits` significant digits d.ddd * 10**exp.
+inline auto ryu_length(bool negative, int num_digits, int exp) noexcept
+    -> size_t {
+  int abs_exp = exp < 0 ? -exp : exp;
+  return size_t(negative) + num_digits + (num_digits > 1) + 1 + (exp < 0) +
+         (abs_exp >= 100 ? 3 : abs_exp >= 10 ? 2 : 1);
+}
+
+}  // namespace dtoa_length
+
+#endif  // DTOA_LENGTH_H_
@@ -0,0 +1,66 @@
+// Interface of engine plug-ins, shared objects that dtoa-benchmark loads with
+// --plugin=<path.so> to benchmark out-of-tree builds without rebuilding the
+// harness.
+//
+// A plug-in exports
+//
+//   extern "C" const dtoa_plugin* dtoa_plugin_get(void);
+//
+// returning a table whose methods are verified and benchmarked like the
+// in-tree ones (see register_method in benchmark.h) under the name
+// <name>@<plug-in>, where <plug-in> is the file name without the directory,
+// "lib" prefix and extension. A `reference` naming another method of the same
+// plug-in refers to it, otherwise to an in-tree method, e.g. "zmij" to check
+// a patched zmij against the vendored one.
+//
+// This header is C-compatible and doesn't depend on the rest of the harness.
+
+#ifndef DTOA_PLUGIN_H_
+#define DTOA_PLUGIN_H_
+
+#include <stddef.h>  // size_t
+
+// Incremented when the layout of dtoa_plugin or dtoa_plugin_method changes.
+#define DTOA_PLUGIN_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dtoa_plugin_method {
+  const char* name;
+  // Same contract as dtoa_fun: returns one past the last character written.
+  char* (*dtoa)(double value, char* buffer);
+  const char* reference;  // Optional.
+  int max_write;          // Optional, 0 if not declared.
+  // Optional exact output size, same contract as dtoa_length_fun.
+  size_t (*length)(double value);
+};
+
+struct dtoa_plugin {
+  int version;  // DTOA_PLUGIN_VERSION
+  int num_methods;
+  const struct dtoa_plugin_method* methods;
+};
+
+typedef const struct dtoa_plugin* (*dtoa_plugin_get_fun)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#  define DTOA_PLUGIN_EXTERN_C extern "C"
+#else
+#  define DTOA_PLUGIN_EXTERN_C
+#endif
+
+// Marks the definition of dtoa_plugin_get.
+#if defined(_WIN32)
+#  define DTOA_PLUGIN_EXPORT DTOA_PLUGIN_EXTERN_C __declspec(dllexport)
+#else
+#  define DTOA_PLUGIN_EXPORT \
+    DTOA_PLUGIN_EXTERN_C __attribute__((visibility("default")))
+#endif
+
+#endif  // DTOA_PLUGIN_H_
@@ -1,7 +1,19 @@
 #define FMT_HEADER_ONLY 1
+#include <cmath>
+
 #include "benchmark.h"
+#include "dtoa-length.h"
 #include "fmt/compile.h"
 
-static register_method _("fmt", [](double value, char* buffer) {
+static register_method_inline _("fmt", [](double value, char* buffer) {
   return fmt::format_to(buffer, FMT_COMPILE("{}"), value);
+}, nullptr, 24, [](double value) -> size_t {
+  bool negative = std::signbit(value);
+  if (!std::isfinite(value)) return negative + 3;  // nan or inf
+  if (value == 0) return negative + 1;
+  // Same digits as fmt::format_to, without trailing zeros.
+  auto dec = fmt::detail::dragonbox::to_decimal(value);
+  int num_digits = dtoa_length::count_digits(dec.significand);
+  return dtoa_length::fmt_length(negative, num_digits,
+                                 dec.exponent + num_digits - 1);
 });
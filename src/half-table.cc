@@ -0,0 +1,78 @@
+#include "half-table.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#  include <immintrin.h>
+#endif
+
+half_table::half_table(htoa_fun generate) : entries_(0x8000) {
+  std::vector<char> chars;
+  for (uint32_t bits = 0; bits < 0x8000; ++bits) {
+    char buffer[64];
+    size_t length = generate(uint16_t(bits), buffer) - buffer;
+    char negative[64];
+    bool is_signed =
+        size_t(generate(uint16_t(bits | 0x8000), negative) - negative) ==
+        length + 1;
+    uint32_t offset = uint32_t(chars.size());
+    chars.push_back('-');
+    chars.insert(chars.end(), buffer, buffer + length);
+    entries_[bits] = offset << offset_shift |
+                     uint32_t(is_signed) << signed_shift | uint32_t(length);
+  }
+  // Padding for the fixed-size copies.
+  chars_size_ = chars.size() + max_write;
+  chars_.reset(new char[chars_size_]());
+  memcpy(chars_.get(), chars.data(), chars.size());
+}
+
+auto half_table::write_batch_scalar(const uint16_t* values, size_t count,
+                                    char* out) const noexcept -> char* {
+  for (size_t i = 0; i < count; ++i) {
+    out = write(values[i], out);
+    *out++ = '\n';
+  }
+  return out;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+auto half_table::write_batch_avx2(const uint16_t* values, size_t count,
+                                  char* out) const noexcept -> char* {
+  const int* entries = reinterpret_cast<const int*>(entries_.data());
+  const __m256i index_mask = _mm256_set1_epi32(0x7fff);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i length = _mm256_set1_epi32(length_mask);
+  alignas(32) uint32_t starts[8], lengths[8];
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    __m256i bits = _mm256_cvtepu16_epi32(v);
+    __m256i e = _mm256_i32gather_epi32(
+        entries, _mm256_and_si256(bits, index_mask), 4);
+    __m256i negative = _mm256_and_si256(
+        _mm256_and_si256(_mm256_srli_epi32(bits, 15),
+                         _mm256_srli_epi32(e, signed_shift)),
+        one);
+    __m256i start = _mm256_sub_epi32(
+        _mm256_add_epi32(_mm256_srli_epi32(e, offset_shift), one), negative);
+    __m256i len =
+        _mm256_add_epi32(_mm256_and_si256(e, length), negative);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(starts), start);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lengths), len);
+    for (int j = 0; j < 8; ++j) {
+      memcpy(out, chars_.get() + starts[j], max_write);
+      out += lengths[j];
+      *out++ = '\n';
+    }
+  }
+  return write_batch_scalar(values + i, count - i, out);
+}
+#endif
+
+auto half_table::write_batch(const uint16_t* values, size_t count,
+                             char* out) const noexcept -> char* {
+#if defined(__x86_64__) && defined(__GNUC__)
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) return write_batch_avx2(values, count, out);
+#endif
+  return write_batch_scalar(values, count, out);
+}
@@ -0,0 +1,69 @@
+// Lookup-table formatting of 16-bit floating-point values.
+//
+// A 16-bit format has only 32768 non-negative values, so their shortest
+// representations can all be precomputed. half_table keeps them in a packed
+// string table: the strings back to back, each preceded by a '-' that is
+// included for negative values, plus one 32-bit entry per value with the
+// offset and length of its string. A conversion is one entry load and one
+// 16-byte copy.
+
+#ifndef HALF_TABLE_H_
+#define HALF_TABLE_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint16_t, uint32_t
+#include <string.h>  // memcpy
+
+#include <memory>
+#include <vector>
+
+#include "benchmark.h"  // htoa_fun
+
+class half_table {
+ public:
+  // Upper bound on the bytes stored by write, including the sign.
+  static constexpr int max_write = 16;
+
+  // Builds the table from the output of `generate` for every value.
+  explicit half_table(htoa_fun generate);
+
+  auto write(uint16_t bits, char* buffer) const noexcept -> char* {
+    uint32_t entry = entries_[bits & 0x7fff];
+    // NaNs are written without a sign, like in ryu's generic_to_chars.
+    uint32_t negative = (bits >> 15) & (entry >> signed_shift);
+    memcpy(buffer, chars_.get() + (entry >> offset_shift) + 1 - negative,
+           max_write);
+    return buffer + (entry & length_mask) + negative;
+  }
+
+  // Converts values[0, count), each followed by '\n'. Gathers the entries of
+  // 8 values at a time with AVX2 where available.
+  auto write_batch(const uint16_t* values, size_t count, char* out) const
+      noexcept -> char*;
+
+  // Bytes of entries and strings.
+  auto footprint() const -> size_t {
+    return entries_.size() * sizeof(uint32_t) + chars_size_;
+  }
+
+ private:
+  // Entry layout: offset of the '-' << offset_shift | signed << signed_shift |
+  // length without the sign.
+  static constexpr int signed_shift = 5;
+  static constexpr int offset_shift = 6;
+  static constexpr uint32_t length_mask = (1 << signed_shift) - 1;
+
+  auto write_batch_scalar(const uint16_t* values, size_t count,
+                          char* out) const noexcept -> char*;
+#if defined(__x86_64__) && defined(__GNUC__)
+  __attribute__((target("avx2"))) auto write_batch_avx2(
+      const uint16_t* values, size_t count, char* out) const noexcept
+      -> char*;
+#endif
+
+  std::vector<uint32_t> entries_;
+  std::unique_ptr<char[]> chars_;
+  size_t chars_size_ = 0;
+};
+
+#endif  // HALF_TABLE_H_
@@ -0,0 +1,64 @@
+#include <string.h>
+
+#include "benchmark.h"
+#include "half-table.h"
+
+// Both ryu's generic_128 and schubfach_16 need unsigned __int128.
+#ifdef __SIZEOF_INT128__
+#  include "ryu/ryu_generic_128.h"
+#  include "schubfach/schubfach_16.h"
+
+// ryu's generic_binary_to_decimal is not always the closest shortest
+// representation for bfloat16 (e.g. 1E-40 for 0x0001 which is closer to
+// 9E-41), so it is not used as a reference.
+static register_htoa_method ryu_generic_f16(
+    "ryu-generic", half_format::binary16, [](uint16_t bits, char* buffer) {
+      return buffer + generic_to_chars(
+                          generic_binary_to_decimal(bits, 10, 5, false),
+                          buffer);
+    });
+
+static register_htoa_method ryu_generic_bf16(
+    "ryu-generic", half_format::bfloat16, [](uint16_t bits, char* buffer) {
+      return buffer + generic_to_chars(
+                          generic_binary_to_decimal(bits, 7, 8, false),
+                          buffer);
+    });
+
+static register_htoa_method schubfach_f16("schubfach", half_format::binary16,
+                                          schubfach::binary16_to_chars,
+                                          "ryu-generic");
+
+static register_htoa_method schubfach_bf16("schubfach", half_format::bfloat16,
+                                           schubfach::bfloat16_to_chars);
+
+static auto binary16_table() -> const half_table& {
+  static const half_table table(schubfach::binary16_to_chars);
+  return table;
+}
+
+static auto bfloat16_table() -> const half_table& {
+  static const half_table table(schubfach::bfloat16_to_chars);
+  return table;
+}
+
+static register_htoa_method lut_f16(
+    "lut", half_format::binary16,
+    [](uint16_t bits, char* buffer) {
+      return binary16_table().write(bits, buffer);
+    },
+    "schubfach",
+    [](const uint16_t* values, size_t count, char* out) {
+      return binary16_table().write_batch(values, count, out);
+    });
+
+static register_htoa_method lut_bf16(
+    "lut", half_format::bfloat16,
+    [](uint16_t bits, char* buffer) {
+      return bfloat16_table().write(bits, buffer);
+    },
+    "schubfach",
+    [](const uint16_t* values, size_t count, char* out) {
+      return bfloat16_table().write_batch(values, count, out);
+    });
+#endif
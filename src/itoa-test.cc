@@ -0,0 +1,59 @@
+#define FMT_HEADER_ONLY 1
+#include <string.h>
+
+#include <charconv>
+#include <type_traits>
+
+#include "asteria/ascii_numput.hpp"
+#include "bcd-itoa.h"
+#include "benchmark.h"
+#include "fmt/compile.h"
+
+extern "C" {
+char* yy_u32_to_string(uint32_t val, char* buf);
+char* yy_u64_to_string(uint64_t val, char* buf);
+char* yy_i64_to_string(int64_t val, char* buf);
+}
+
+template <typename Int> auto to_chars_itoa(Int value, char* buffer) -> char* {
+  return std::to_chars(buffer, buffer + 24, value).ptr;
+}
+
+static register_itoa_method to_chars_u32("to_chars", to_chars_itoa<uint32_t>);
+static register_itoa_method to_chars_u64("to_chars", to_chars_itoa<uint64_t>);
+static register_itoa_method to_chars_i64("to_chars", to_chars_itoa<int64_t>);
+
+template <typename Int> auto fmt_itoa(Int value, char* buffer) -> char* {
+  return fmt::format_to(buffer, FMT_COMPILE("{}"), value);
+}
+
+static register_itoa_method fmt_u32("fmt", fmt_itoa<uint32_t>);
+static register_itoa_method fmt_u64("fmt", fmt_itoa<uint64_t>);
+static register_itoa_method fmt_i64("fmt", fmt_itoa<int64_t>);
+
+template <typename Int> auto asteria_itoa(Int value, char* buffer) -> char* {
+  rocket::ascii_numput p;
+  if constexpr (std::is_signed_v<Int>)
+    p.put_DI(value);
+  else
+    p.put_DU(value);
+  size_t size = p.size();
+  memcpy(buffer, p.data(), size);
+  return buffer + size;
+}
+
+static register_itoa_method asteria_u32("asteria", asteria_itoa<uint32_t>);
+static register_itoa_method asteria_u64("asteria", asteria_itoa<uint64_t>);
+static register_itoa_method asteria_i64("asteria", asteria_itoa<int64_t>);
+
+static register_itoa_method yy_u32("yy", yy_u32_to_string);
+static register_itoa_method yy_u64("yy", yy_u64_to_string);
+static register_itoa_method yy_i64("yy", yy_i64_to_string);
+
+template <typename Int> auto zmij_bcd_itoa(Int value, char* buffer) -> char* {
+  return bcd_itoa::write(value, buffer);
+}
+
+static register_itoa_method zmij_bcd_u32("zmij-bcd", zmij_bcd_itoa<uint32_t>);
+static register_itoa_method zmij_bcd_u64("zmij-bcd", zmij_bcd_itoa<uint64_t>);
+static register_itoa_method zmij_bcd_i64("zmij-bcd", zmij_bcd_itoa<int64_t>);
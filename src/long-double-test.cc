@@ -0,0 +1,71 @@
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <charconv>
+
+#include "benchmark.h"
+#include "schubfach/schubfach_ld.h"
+
+// ryu's generic_128 needs unsigned __int128.
+#ifdef __SIZEOF_INT128__
+#  include "ryu/ryu_generic_128.h"
+#endif
+
+#ifdef DTOA_HAVE_QUADMATH
+#  include <quadmath.h>
+#endif
+
+#ifdef __SIZEOF_INT128__
+static register_ldtoa_method ryu_generic("ryu-generic", [](long double value,
+                                                           char* buffer) {
+  return buffer + generic_to_chars(long_double_to_fd128(value), buffer);
+});
+#endif
+
+#if LDBL_MANT_DIG == 64 && defined(__SIZEOF_INT128__)
+// Same output format as generic_to_chars.
+static register_ldtoa_method schubfach_ld("schubfach", schubfach::ldtoa,
+                                          "ryu-generic");
+#endif
+
+static register_ldtoa_method to_chars("to_chars", [](long double value,
+                                                     char* buffer) {
+  return std::to_chars(buffer, buffer + 64, value).ptr;
+});
+
+// LDBL_DECIMAL_DIG = 21 digits round-trip.
+static register_ldtoa_method sprintf_ld("sprintf", [](long double value,
+                                                      char* buffer) {
+  return buffer + snprintf(buffer, 64, "%.21Lg", value);
+});
+
+static register_ldtoa_method sprintf_hex("sprintf-hex", [](long double value,
+                                                           char* buffer) {
+  return buffer + snprintf(buffer, 64, "%La", value);
+});
+
+#if defined(__SIZEOF_FLOAT128__) && defined(__SIZEOF_INT128__)
+static register_f128toa_method ryu_generic_f128("ryu-generic",
+                                                [](__float128 value,
+                                                   char* buffer) {
+  unsigned __int128 bits = 0;
+  memcpy(&bits, &value, sizeof(value));
+  return buffer + generic_to_chars(generic_binary_to_decimal(bits, 112, 15,
+                                                             false),
+                                   buffer);
+});
+#endif
+
+#ifdef DTOA_HAVE_QUADMATH
+// FLT128_DECIMAL_DIG = 36 digits round-trip.
+static register_f128toa_method quadmath_f128("quadmath", [](__float128 value,
+                                                            char* buffer) {
+  return buffer + quadmath_snprintf(buffer, 64, "%.36Qg", value);
+});
+
+static register_f128toa_method quadmath_hex("quadmath-hex", [](__float128 value,
+                                                               char* buffer) {
+  return buffer + quadmath_snprintf(buffer, 64, "%Qa", value);
+});
+#endif
@@ -0,0 +1,168 @@
+// NUMA placement benchmark for dtoa implementations.
+//
+// On multi-node machines read-only tables live on whichever node first
+// touched the page, so threads on other nodes read them remotely. This tool
+// pins threads to the CPUs of each node in turn and measures aggregate
+// throughput with the tables of the *-relocatable methods (see
+// table-placement.h) bound to each node: the diagonal corresponds to per-node
+// replicated copies, the rest to remote access. Other methods are measured
+// with their tables in .rodata for reference.
+//
+// Tables are small enough to stay cached once warm, so remote placement shows
+// up mostly when the caches are shared or thrashed by other work.
+//
+// Usage: ./numa-benchmark [method] [threads_per_node] [rounds]
+
+#include "cpu-topology.h"
+#include "table-placement.h"
+#include "tool-methods.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct numa_node {
+  int id;
+  std::vector<int> cpus;
+};
+
+static auto get_nodes() -> std::vector<numa_node> {
+  std::vector<numa_node> nodes;
+  for (int id : read_cpu_list("/sys/devices/system/node/online")) {
+    auto path = "/sys/devices/system/node/node" + std::to_string(id) + "/cpulist";
+    nodes.push_back({id, read_cpu_list(path)});
+  }
+  if (nodes.empty()) {
+    // No NUMA support in the kernel: treat the machine as a single node.
+    numa_node node{0, {}};
+    for (int cpu = 0, n = int(std::thread::hardware_concurrency()); cpu < n; ++cpu)
+      node.cpus.push_back(cpu);
+    nodes.push_back(node);
+  }
+  return nodes;
+}
+
+// Runs `dtoa` on one thread per CPU in `cpus` and returns the aggregate
+// throughput in millions of conversions per second.
+static double measure_throughput(dtoa_fun dtoa, const std::vector<int>& cpus,
+                                 int rounds) {
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (int cpu : cpus) {
+    threads.emplace_back([&, cpu]() {
+      pin_to_cpu(cpu);
+      char buffer[256];
+      for (int i = 0; i < NUM_TEST_VALUES; i++) dtoa(test_values[i], buffer);
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) {}
+      for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < NUM_TEST_VALUES; i++) dtoa(test_values[i], buffer);
+      }
+    });
+  }
+  while (ready.load() != int(cpus.size())) {}
+  auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& t : threads) t.join();
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+  return double(cpus.size()) * rounds * NUM_TEST_VALUES / seconds / 1e6;
+}
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  int threads_per_node = argc > 2 ? atoi(argv[2]) : 0;
+  int rounds = argc > 3 ? atoi(argv[3]) : 20000;
+
+  init_test_values();
+
+  std::sort(methods.begin(), methods.end(),
+            [](const method& a, const method& b) { return a.name < b.name; });
+
+  std::vector<numa_node> nodes = get_nodes();
+  for (numa_node& node : nodes) {
+    if (threads_per_node > 0 && int(node.cpus.size()) > threads_per_node)
+      node.cpus.resize(threads_per_node);
+  }
+
+  printf("NUMA placement benchmark (%zu node%s)\n", nodes.size(),
+         nodes.size() > 1 ? "s" : "");
+  for (const numa_node& node : nodes)
+    printf("  node%d: %zu thread%s\n", node.id, node.cpus.size(),
+           node.cpus.size() != 1 ? "s" : "");
+  printf("\nThroughput in M conversions/s; columns = where the tables are\n\n");
+
+  int name_width = 6;
+  for (const auto& m : methods) {
+    int len = static_cast<int>(m.name.size()) + 12;  // " @ node0"
+    if (len > name_width) name_width = len;
+  }
+
+  printf("%-*s %8s", name_width, "Method @ CPUs", "rodata");
+  for (const numa_node& node : nodes) {
+    char hdr[16];
+    snprintf(hdr, sizeof(hdr), "node%d", node.id);
+    printf(" %8s", hdr);
+  }
+  printf("  %7s\n", "remote");
+  printf("%-*s %8s", name_width, "-------------", "--------");
+  for (size_t i = 0; i < nodes.size(); i++) printf(" %8s", "--------");
+  printf("  %7s\n", "-------");
+
+  for (const auto& m : methods) {
+    if (m.name == "null" || m.name == "ostringstream" || m.name == "sprintf")
+      continue;
+    if (filter && m.name != filter) continue;
+    bool relocatable = has_relocatable_tables(m.name.c_str());
+
+    for (const numa_node& cpu_node : nodes) {
+      if (cpu_node.cpus.empty()) continue;  // Memory-only node.
+      std::string label = m.name + " @ node" + std::to_string(cpu_node.id);
+      printf("%-*s", name_width, label.c_str());
+      fflush(stdout);
+
+      place_tables(table_placement::rodata);
+      printf(" %8.1f", measure_throughput(m.dtoa, cpu_node.cpus, rounds));
+      fflush(stdout);
+
+      double local = 0, remote = 0;
+      int num_remote = 0;
+      for (const numa_node& table_node : nodes) {
+        if (!relocatable ||
+            !place_tables(table_placement::numa_node, table_node.id)) {
+          printf(" %8s", "-");
+          continue;
+        }
+        double mps = measure_throughput(m.dtoa, cpu_node.cpus, rounds);
+        printf(" %8.1f", mps);
+        fflush(stdout);
+        if (table_node.id == cpu_node.id) {
+          local = mps;
+        } else {
+          remote += mps;
+          ++num_remote;
+        }
+      }
+      if (local > 0 && num_remote > 0)
+        printf("  %6.1f%%\n", (1 - remote / num_remote / local) * 100);
+      else
+        printf("  %7s\n", "-");
+    }
+  }
+  place_tables(table_placement::rodata);
+
+  printf("\nnodeN = relocatable tables bound to node N; the CPU's own node is\n");
+  printf("the per-node replicated case\n");
+  printf("Remote = throughput loss of remote nodes vs the local copy\n");
+  return 0;
+}
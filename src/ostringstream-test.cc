@@ -10,4 +10,4 @@ static register_method _("ostringstream", [](double value, char* buffer) {
   std::string s = oss.str();
   memcpy(buffer, s.data(), s.size());
   return buffer + s.size();
-});
+}, nullptr, 24);
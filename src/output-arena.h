@@ -0,0 +1,147 @@
+// Bulk output buffers for serializer-style writes.
+//
+// The regular benchmark loops convert into a stack buffer that stays in L1.
+// A serializer instead appends to a large, fresh output area, which costs
+// store bandwidth and, for lines not yet in cache, a read for ownership
+// (write-allocate). output_arena is such an area, optionally backed by huge
+// pages. nt_appender appends through a small staging buffer that is copied to
+// the arena with non-temporal stores, which bypass the cache and avoid the
+// read for ownership.
+
+#ifndef OUTPUT_ARENA_H_
+#define OUTPUT_ARENA_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uintptr_t
+#include <string.h>  // memcpy, memmove, memset
+
+#include <new>  // std::align_val_t
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif
+#ifdef __SSE2__
+#  include <emmintrin.h>  // _mm_stream_si128, _mm_sfence
+#endif
+
+class output_arena {
+ private:
+  char* data_ = nullptr;
+  size_t size_ = 0;
+  const char* kind_ = "4k";
+  bool mapped_ = false;
+
+  static constexpr size_t huge_page_size = size_t(2) << 20;
+
+ public:
+  // Allocates `size` bytes and writes them once so that the timed writes
+  // don't page fault. With `huge`, tries MAP_HUGETLB, then transparent huge
+  // pages (madvise), then 4K pages; kind() tells which one was used.
+  output_arena(size_t size, bool huge) {
+    size_ = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+#if defined(MAP_HUGETLB)
+    if (huge) {
+      void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED) {
+        data_ = static_cast<char*>(p);
+        kind_ = "hugetlb";
+        mapped_ = true;
+      }
+    }
+#endif
+#if defined(MADV_HUGEPAGE)
+    if (huge && !data_) {
+      // Over-allocate to align the start to a huge page.
+      size_t mapped_size = size_ + huge_page_size;
+      void* p = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p != MAP_FAILED) {
+        auto start = reinterpret_cast<uintptr_t>(p);
+        auto aligned = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+        if (aligned != start) munmap(p, aligned - start);
+        size_t tail = start + mapped_size - (aligned + size_);
+        if (tail > 0)
+          munmap(reinterpret_cast<void*>(aligned + size_), tail);
+        data_ = reinterpret_cast<char*>(aligned);
+        mapped_ = true;
+        if (madvise(data_, size_, MADV_HUGEPAGE) == 0) kind_ = "thp";
+      }
+    }
+#endif
+    if (!data_) data_ = new (std::align_val_t(4096)) char[size_];
+    memset(data_, 0, size_);
+  }
+
+  ~output_arena() {
+#ifndef _WIN32
+    if (mapped_) {
+      munmap(data_, size_);
+      return;
+    }
+#endif
+    operator delete[](data_, std::align_val_t(4096));
+  }
+
+  output_arena(const output_arena&) = delete;
+  void operator=(const output_arena&) = delete;
+
+  auto data() const -> char* { return data_; }
+  auto size() const -> size_t { return size_; }
+
+  // "hugetlb", "thp" (requested, not verified) or "4k".
+  auto kind() const -> const char* { return kind_; }
+};
+
+// Appends to `out` through a staging buffer that stays in L1. Full 64-byte
+// lines of the staging buffer are copied to `out` with non-temporal stores;
+// `out` must be 64-byte aligned. Without SSE2 this is a plain copy.
+class nt_appender {
+ private:
+  static constexpr size_t line_size = 64;
+  static constexpr size_t staging_size = 4096;
+
+  alignas(line_size) char staging_[staging_size + 256];
+  char* out_;
+  size_t staged_ = 0;
+
+  static void stream(char* dst, const char* src, size_t size) {
+#ifdef __SSE2__
+    for (size_t i = 0; i < size; i += 16) {
+      __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(src + i));
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+#else
+    memcpy(dst, src, size);
+#endif
+  }
+
+ public:
+  explicit nt_appender(char* out) : out_(out) {}
+
+  // Returns where to write the next value; at least 256 bytes are available.
+  auto pos() -> char* { return staging_ + staged_; }
+
+  // Commits the bytes written up to `end`.
+  void commit(char* end) {
+    staged_ = end - staging_;
+    if (staged_ < staging_size) return;
+    size_t lines = staged_ & ~(line_size - 1);
+    stream(out_, staging_, lines);
+    out_ += lines;
+    staged_ -= lines;
+    memmove(staging_, staging_ + lines, staged_);
+  }
+
+  // Writes out the staged tail and orders the non-temporal stores.
+  void flush() {
+    memcpy(out_, staging_, staged_);
+    out_ += staged_;
+    staged_ = 0;
+#ifdef __SSE2__
+    _mm_sfence();
+#endif
+  }
+};
+
+#endif  // OUTPUT_ARENA_H_
@@ -0,0 +1,95 @@
+#include "plugin-loader.h"
+
+#include <string.h>  // memcmp
+
+#include <stdexcept>  // std::runtime_error
+
+#ifndef _WIN32
+#  include <dlfcn.h>
+#endif
+#ifdef __linux__
+#  include <elf.h>   // NT_GNU_BUILD_ID
+#  include <link.h>  // dl_iterate_phdr
+#endif
+
+namespace {
+
+// Returns the name of a plug-in for method names: libfoo.so -> foo.
+auto plugin_name(const std::string& path) -> std::string {
+  std::string name = path.substr(path.find_last_of('/') + 1);
+  if (name.compare(0, 3, "lib") == 0) name = name.substr(3);
+  return name.substr(0, name.find('.'));
+}
+
+#ifdef __linux__
+struct build_id_query {
+  ElfW(Addr) base;
+  std::string build_id;
+};
+
+// Finds the NT_GNU_BUILD_ID note in the PT_NOTE segments of the object loaded
+// at query->base.
+auto find_build_id(dl_phdr_info* info, size_t, void* data) -> int {
+  auto* query = static_cast<build_id_query*>(data);
+  if (info->dlpi_addr != query->base) return 0;
+  for (int i = 0; i < info->dlpi_phnum; ++i) {
+    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+    if (phdr.p_type != PT_NOTE) continue;
+    auto p = reinterpret_cast<const char*>(info->dlpi_addr + phdr.p_vaddr);
+    const char* end = p + phdr.p_memsz;
+    while (p + sizeof(ElfW(Nhdr)) <= end) {
+      auto* note = reinterpret_cast<const ElfW(Nhdr)*>(p);
+      const char* name = p + sizeof(ElfW(Nhdr));
+      auto desc = reinterpret_cast<const unsigned char*>(
+          name + ((note->n_namesz + 3) & ~3u));
+      if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 &&
+          memcmp(name, "GNU", 4) == 0) {
+        static const char hex[] = "0123456789abcdef";
+        for (unsigned j = 0; j < note->n_descsz; ++j) {
+          query->build_id += hex[desc[j] >> 4];
+          query->build_id += hex[desc[j] & 0xf];
+        }
+        return 1;
+      }
+      p = reinterpret_cast<const char*>(desc) + ((note->n_descsz + 3) & ~3u);
+    }
+  }
+  return 1;
+}
+#endif
+
+}  // namespace
+
+auto load_plugin(const std::string& path) -> loaded_plugin {
+#ifdef _WIN32
+  throw std::runtime_error("plug-ins are not supported on Windows");
+#else
+  // RTLD_LOCAL keeps the engine's symbols, e.g. a patched zmij::write, from
+  // being resolved to or from the in-tree copy.
+  void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle) throw std::runtime_error(dlerror());
+  auto get = reinterpret_cast<dtoa_plugin_get_fun>(
+      dlsym(handle, "dtoa_plugin_get"));
+  if (!get) throw std::runtime_error("no dtoa_plugin_get in " + path);
+  const dtoa_plugin* plugin = get();
+  if (!plugin || plugin->version != DTOA_PLUGIN_VERSION) {
+    throw std::runtime_error(path + ": expected plug-in version " +
+                             std::to_string(DTOA_PLUGIN_VERSION));
+  }
+
+  loaded_plugin result;
+  result.path = path;
+  result.name = plugin_name(path);
+  result.methods.assign(plugin->methods,
+                        plugin->methods + plugin->num_methods);
+#  ifdef __linux__
+  link_map* map = nullptr;
+  if (dlinfo(handle, RTLD_DI_LINKMAP, &map) == 0) {
+    build_id_query query = {map->l_addr, {}};
+    dl_iterate_phdr(find_build_id, &query);
+    result.build_id = std::move(query.build_id);
+  }
+#  endif
+  return result;
+#endif
+}
@@ -0,0 +1,23 @@
+// Loading of engine plug-ins (--plugin=<path.so>), see dtoa-plugin.h.
+
+#ifndef PLUGIN_LOADER_H_
+#define PLUGIN_LOADER_H_
+
+#include <string>
+#include <vector>
+
+#include "dtoa-plugin.h"
+
+struct loaded_plugin {
+  std::string path;
+  std::string name;      // File name without directory, "lib" and extension.
+  std::string build_id;  // Hex GNU build ID, empty if the object has none.
+  std::vector<dtoa_plugin_method> methods;
+};
+
+// Loads the plug-in at `path` and returns its methods, which stay valid until
+// exit since plug-ins are never unloaded. Throws std::runtime_error if it
+// can't be loaded, doesn't export dtoa_plugin_get or has another version.
+auto load_plugin(const std::string& path) -> loaded_plugin;
+
+#endif  // PLUGIN_LOADER_H_
@@ -0,0 +1,50 @@
+// Portable fallback paths of zmij, xjb64 and yy, compiled a second time
+// under other names (see zmij-no-int128.cc, zmij-no-builtins.cc,
+// xjb64-no-int128.cpp and yy-no-int128.c), so that their cost is measured
+// on a 64-bit host next to the default builds. Each must produce the same
+// output as the default build.
+
+#include "benchmark.h"
+#include "zmij/zmij.h"
+
+namespace zmij_no_int128::detail {
+template <typename Float>
+auto write(Float value, char* buffer) noexcept -> char*;
+}  // namespace zmij_no_int128::detail
+
+namespace zmij_no_builtins::detail {
+template <typename Float>
+auto write(Float value, char* buffer) noexcept -> char*;
+}  // namespace zmij_no_builtins::detail
+
+extern "C" char* yy_no_int128_double_to_string(double val, char* buf);
+
+static register_method zmij_no_int128_method(
+    "zmij-no-int128",
+    [](double value, char* buffer) {
+      return zmij_no_int128::detail::write(value, buffer);
+    },
+    "zmij", zmij::double_buffer_size);
+
+static register_method zmij_no_builtins_method(
+    "zmij-no-builtins",
+    [](double value, char* buffer) {
+      return zmij_no_builtins::detail::write(value, buffer);
+    },
+    "zmij", zmij::double_buffer_size);
+
+#ifdef __SIZEOF_INT128__
+char* xjb64_no_int128(double v, char* buf);
+
+static register_method xjb64_no_int128_method(
+    "xjb64-no-int128",
+    [](double value, char* buffer) { return xjb64_no_int128(value, buffer); },
+    "xjb64", 32);
+#endif
+
+static register_method yy_no_int128_method(
+    "yy-no-int128",
+    [](double value, char* buffer) {
+      return yy_no_int128_double_to_string(value, buffer);
+    },
+    "yy", 40);
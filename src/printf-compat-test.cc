@@ -0,0 +1,10 @@
+#include "benchmark.h"
+#include "printf-compat.h"
+
+// std::setprecision(17) with the default floatfield is %.17g, so in the "C"
+// locale both methods share the same formatter.
+static register_method sprintf_compat("sprintf-compat",
+                                      printf_compat::write_g17, "sprintf", 24);
+static register_method ostream_compat("ostream-compat",
+                                      printf_compat::write_g17,
+                                      "ostringstream", 24);
@@ -0,0 +1,124 @@
+// Drop-in replacements for printf("%.17g", x) and for streaming x with
+// std::setprecision(17), which give the same bytes as glibc and libstdc++ in
+// the "C" locale without locale lookups or allocations.
+//
+// The digits come from zmij when the shortest representation has 17
+// significant digits, in which case it is also the correctly rounded 17-digit
+// one, and from Ryu's exact %.16e (ryu/d2fixed.c) otherwise.
+
+#ifndef PRINTF_COMPAT_H_
+#define PRINTF_COMPAT_H_
+
+#include <stdint.h>  // uint64_t
+#include <string.h>  // memcpy, memset
+
+#include <bit>  // std::countr_zero
+
+#include "ryu/ryu.h"
+#include "zmij/zmij.h"
+
+namespace printf_compat {
+
+constexpr int precision = 17;
+
+// Writes the number digits[0].digits[1...] * 10**exp with `num_digits`
+// significant digits in the %g style with that precision: fixed notation if
+// -4 <= exp < num_digits and exponential otherwise, without trailing zeros.
+inline auto write_general(char* out, const char* digits, int exp,
+                          int num_digits = precision) -> char* {
+  int n = num_digits;
+  while (n > 1 && digits[n - 1] == '0') --n;
+  if (exp < -4 || exp >= num_digits) {
+    *out++ = digits[0];
+    if (n > 1) {
+      *out++ = '.';
+      memcpy(out, digits + 1, n - 1);
+      out += n - 1;
+    }
+    *out++ = 'e';
+    *out++ = exp < 0 ? '-' : '+';
+    unsigned e = exp < 0 ? -exp : exp;
+    if (e >= 100) {
+      *out++ = char('0' + e / 100);
+      e %= 100;
+    }
+    *out++ = char('0' + e / 10);
+    *out++ = char('0' + e % 10);
+    return out;
+  }
+  if (exp < 0) {
+    *out++ = '0';
+    *out++ = '.';
+    memset(out, '0', -exp - 1);
+    out += -exp - 1;
+    memcpy(out, digits, n);
+    return out + n;
+  }
+  int int_digits = exp + 1;
+  if (n <= int_digits) {
+    memcpy(out, digits, n);
+    memset(out + n, '0', int_digits - n);
+    return out + int_digits;
+  }
+  memcpy(out, digits, int_digits);
+  out += int_digits;
+  *out++ = '.';
+  memcpy(out, digits + int_digits, n - int_digits);
+  return out + n - int_digits;
+}
+
+// Returns true if the exact value of a positive finite double may lie
+// halfway between two 17-digit decimals, i.e. have 18 significant digits.
+// Integers of 18 digits are even, and a fraction m * 2**-f with odd m has the
+// digits of m * 5**f, more than 18 of them if f > 25.
+inline auto may_be_tie(uint64_t bits) -> bool {
+  int biased_exp = int(bits >> 52);
+  if (biased_exp == 0) return false;  // Subnormals have f > 1000.
+  uint64_t sig = (bits & ((uint64_t(1) << 52) - 1)) | (uint64_t(1) << 52);
+  int fraction_bits = 1075 - biased_exp - std::countr_zero(sig);
+  return fraction_bits > 0 && fraction_bits <= 25;
+}
+
+// Formats `value` like printf("%.17g", value) in the "C" locale.
+inline auto write_g17(double value, char* out) -> char* {
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(value));
+  if (bits >> 63) *out++ = '-';
+  bits &= ~(uint64_t(1) << 63);
+  if (bits >= uint64_t(0x7ff) << 52) {
+    memcpy(out, bits == uint64_t(0x7ff) << 52 ? "inf" : "nan", 3);
+    return out + 3;
+  }
+  if (bits == 0) {
+    *out = '0';
+    return out + 1;
+  }
+
+  char digits[precision];
+  auto dec = zmij::to_decimal(value);
+  if (dec.sig >= 10'000'000'000'000'000 && dec.sig % 10 != 0 &&
+      !may_be_tie(bits)) {
+    unsigned long long sig = dec.sig;
+    for (int i = precision - 1; i >= 0; --i) {
+      digits[i] = char('0' + sig % 10);
+      sig /= 10;
+    }
+    return write_general(out, digits, dec.exp + precision - 1);
+  }
+
+  // d.dddddddddddddddde[+-]XX[X], exactly rounded half to even.
+  char buffer[32];
+  memcpy(&value, &bits, sizeof(value));
+  int size = d2exp_buffered_n(value, precision - 1, buffer);
+  digits[0] = buffer[0];
+  memcpy(digits + 1, buffer + 2, precision - 1);
+  int exp = 0;
+  for (int i = precision + 3; i < size; ++i)
+    exp = exp * 10 + (buffer[i] - '0');
+  if (buffer[precision + 2] == '-') exp = -exp;
+  return write_general(out, digits, exp);
+}
+
+}  // namespace printf_compat
+
+#endif  // PRINTF_COMPAT_H_
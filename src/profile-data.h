@@ -0,0 +1,48 @@
+// Narrow-band test data for table profiling.
+//
+// The benchmark inputs are derived from random bit patterns, so their binary
+// exponents cover the whole double range and touch every entry of the
+// exponent-indexed power-of-10 tables. Real data (measurements, prices,
+// coordinates) sits in a narrow band instead. This dataset models it:
+// 1-17 significant digits with decimal magnitudes in [1e-9, 1e9].
+//
+// Shared by table-profile, which derives hot-subset tables from it, and by
+// cache-pressure / cache-contention (--profile-data), which measure them.
+
+#ifndef PROFILE_DATA_H_
+#define PROFILE_DATA_H_
+
+#include <stdint.h>  // uint64_t
+#include <stdio.h>   // snprintf
+#include <stdlib.h>  // strtod
+
+#include <vector>
+
+constexpr int profile_min_dec_exp = -9;
+constexpr int profile_max_dec_exp = 9;
+
+// Returns `count` doubles cycling through 1-17 significant digits, with
+// decimal exponents uniformly distributed in the profile band.
+inline auto make_profile_values(int count) -> std::vector<double> {
+  std::vector<double> values;
+  values.reserve(count);
+  unsigned seed = 42;
+  auto next = [&]() {
+    seed = 214013 * seed + 2531011;
+    return seed >> 8;
+  };
+  for (int i = 0; i < count; ++i) {
+    int digits = 1 + i % 17;
+    uint64_t sig = 1 + next() % 9;
+    for (int d = 1; d < digits; ++d) sig = sig * 10 + next() % 10;
+    int num_exps = profile_max_dec_exp - profile_min_dec_exp + 1;
+    int dec_exp = profile_min_dec_exp + int(next() % num_exps);
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%llue%d", (unsigned long long)sig,
+             dec_exp - digits + 1);
+    values.push_back(strtod(buf, nullptr));
+  }
+  return values;
+}
+
+#endif  // PROFILE_DATA_H_
@@ -0,0 +1,109 @@
+// Result files shared by dtoa-benchmark and the standalone cache tools.
+//
+// dtoa-benchmark writes results/<machine>_<os>_<compiler>_<commit>.json.
+// cache-pressure and cache-contention write <same base>.<tool>.json next to
+// it, and generate-html.py adds their charts to the same page.
+
+#ifndef RESULTS_H_
+#define RESULTS_H_
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef MACHINE
+#  define MACHINE "unknown"
+#endif
+
+inline auto os_name() -> const char* {
+#if defined(__linux__)
+  return "linux";
+#elif defined(__APPLE__)
+  return "macos";
+#elif defined(_WIN32)
+  return "windows";
+#endif
+  return "unknown";
+}
+
+#define DO_STRINGIFY(x) #x
+#define STRINGIFY(x) DO_STRINGIFY(x)
+
+inline auto compiler_name() -> const char* {
+#if defined(__clang__)
+  return "clang" STRINGIFY(__clang_major__) "." STRINGIFY(__clang_minor__);
+#elif defined(__GNUC__)
+  return "gcc" STRINGIFY(__GNUC__) "." STRINGIFY(__GNUC_MINOR__);
+#elif defined(_MSC_VER)
+  return "msvc";
+#endif
+  return "unknown";
+}
+
+// Returns results/<machine>_<os>_<compiler>[_<commit>][.<tool>].json, the
+// layout consumed by generate-html.py.
+inline auto results_path(const std::string& commit_hash,
+                         const char* tool = nullptr) -> std::string {
+  std::string path = std::string("results/") + MACHINE + "_" + os_name() +
+                     "_" + compiler_name();
+  if (!commit_hash.empty()) path += "_" + commit_hash;
+  if (tool) path += std::string(".") + tool;
+  return path + ".json";
+}
+
+// Stashes provenance in the JSON `context` block. This is in addition to the
+// information already encoded in the file name so consumers don't have to
+// parse the path.
+inline void add_results_context(const std::string& commit_hash) {
+  benchmark::AddCustomContext("machine", MACHINE);
+  benchmark::AddCustomContext("os", os_name());
+  benchmark::AddCustomContext("compiler", compiler_name());
+  if (!commit_hash.empty())
+    benchmark::AddCustomContext("commit_hash", commit_hash);
+}
+
+// A measurement made outside of Google Benchmark's run loop.
+struct result_row {
+  std::string name;
+  double ns;  // Real time per iteration.
+  long long iterations;
+  benchmark::UserCounters counters;
+};
+
+// Writes `rows` with Google Benchmark's own JSON reporter so that the file
+// has the same layout and context (CPU, caches, date, custom keys) as the
+// output of dtoa-benchmark. Requires benchmark::Initialize to have been
+// called.
+inline auto write_results(const std::string& path,
+                          const std::vector<result_row>& rows) -> bool {
+  std::ofstream out(path);
+  if (!out) return false;
+  benchmark::JSONReporter reporter;
+  reporter.SetOutputStream(&out);
+  reporter.SetErrorStream(&out);
+  if (!reporter.ReportContext(benchmark::BenchmarkReporter::Context()))
+    return false;
+  std::vector<benchmark::BenchmarkReporter::Run> runs;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    benchmark::BenchmarkReporter::Run run;
+    run.run_name.function_name = rows[i].name;
+    run.family_index = static_cast<int64_t>(i);
+    run.per_family_instance_index = 0;
+    run.repetitions = 1;
+    run.repetition_index = 0;
+    run.iterations = rows[i].iterations;
+    run.time_unit = benchmark::kNanosecond;
+    run.real_accumulated_time = rows[i].ns * 1e-9 * rows[i].iterations;
+    run.cpu_accumulated_time = run.real_accumulated_time;
+    run.counters = rows[i].counters;
+    runs.push_back(run);
+  }
+  reporter.ReportRuns(runs);
+  reporter.Finalize();
+  out.close();
+  return !out.fail();
+}
+
+#endif  // RESULTS_H_
@@ -0,0 +1,32 @@
+// ryu with DOUBLE_POW5_INV_SPLIT and DOUBLE_POW5_SPLIT read through pointers,
+// so that place_tables() can move them into a huge page (see
+// table-placement.h and ryu-relocatable.c).
+
+#include <stddef.h>
+
+#include "benchmark.h"
+#include "table-placement.h"
+
+extern "C" {
+extern const void* ryu_pow5_inv_split;
+extern const void* ryu_pow5_split;
+extern const void* const ryu_rodata_pow5_inv_split_data;
+extern const void* const ryu_rodata_pow5_split_data;
+extern const size_t ryu_pow5_inv_split_size;
+extern const size_t ryu_pow5_split_size;
+int ryu_relocatable_d2s_buffered_n(double f, char* result);
+}
+
+static relocatable_table inv_table("ryu-relocatable", "DOUBLE_POW5_INV_SPLIT",
+                                   ryu_rodata_pow5_inv_split_data,
+                                   ryu_pow5_inv_split_size, &ryu_pow5_inv_split);
+static relocatable_table table("ryu-relocatable", "DOUBLE_POW5_SPLIT",
+                               ryu_rodata_pow5_split_data, ryu_pow5_split_size,
+                               &ryu_pow5_split);
+
+static register_method _(
+    "ryu-relocatable",
+    [](double value, char* buffer) -> char* {
+      return buffer + ryu_relocatable_d2s_buffered_n(value, buffer);
+    },
+    "ryu", 24);
@@ -0,0 +1,27 @@
+// ryu's d2s compiled a second time with DOUBLE_POW5_INV_SPLIT and
+// DOUBLE_POW5_SPLIT read through pointers, so that place_tables() can move
+// them into a huge page (see table-placement.h). The vendored sources are
+// used unmodified; the entry points are renamed to ryu_relocatable_*.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DOUBLE_POW5_INV_SPLIT ryu_rodata_pow5_inv_split
+#define DOUBLE_POW5_SPLIT ryu_rodata_pow5_split
+#include "ryu/d2s_full_table.h"
+#undef DOUBLE_POW5_INV_SPLIT
+#undef DOUBLE_POW5_SPLIT
+
+const void* ryu_pow5_inv_split = ryu_rodata_pow5_inv_split;
+const void* ryu_pow5_split = ryu_rodata_pow5_split;
+const void* const ryu_rodata_pow5_inv_split_data = ryu_rodata_pow5_inv_split;
+const void* const ryu_rodata_pow5_split_data = ryu_rodata_pow5_split;
+const size_t ryu_pow5_inv_split_size = sizeof(ryu_rodata_pow5_inv_split);
+const size_t ryu_pow5_split_size = sizeof(ryu_rodata_pow5_split);
+
+#define DOUBLE_POW5_INV_SPLIT ((const uint64_t(*)[2])ryu_pow5_inv_split)
+#define DOUBLE_POW5_SPLIT ((const uint64_t(*)[2])ryu_pow5_split)
+#define d2s_buffered_n ryu_relocatable_d2s_buffered_n
+#define d2s_buffered ryu_relocatable_d2s_buffered
+#define d2s ryu_relocatable_d2s
+#include "ryu/d2s.c"
@@ -4,4 +4,4 @@
 
 static register_method _("ryu", [](double value, char* buffer) -> char* {
   return buffer + d2s_buffered_n(value, buffer);
-});
+}, nullptr, 24);
@@ -133,7 +133,13 @@ struct floating_decimal_128 generic_binary_to_decimal(
   // Step 2: Determine the interval of legal decimal representations.
   const uint128_t mv = 4 * m2;
   // Implicit bool -> int conversion. True is 1, false is 0.
-  const uint32_t mmShift = (ieeeMantissa != 0) || (ieeeExponent == 0);
+  // With an explicit leading bit the significand of a power of two is not 0;
+  // compare the fraction bits only, or the lower boundary of powers of two is
+  // too wide and the result may not round-trip.
+  const uint128_t fraction = explicitLeadingBit
+      ? ieeeMantissa & ((ONE << (mantissaBits - 1)) - 1)
+      : ieeeMantissa;
+  const uint32_t mmShift = (fraction != 0) || (ieeeExponent <= 1);
 
   // Step 3: Convert to a decimal power base using 128-bit arithmetic.
   uint128_t vr, vp, vm;
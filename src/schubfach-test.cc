@@ -6,4 +6,4 @@
 
 static register_method _("schubfach", [](double x, char* buffer) -> char* {
   return schubfach::dtoa(x, buffer);
-});
+}, nullptr, schubfach::buffer_size);
@@ -0,0 +1,271 @@
+// Schubfach for the 16-bit formats IEEE 754 binary16 and bfloat16:
+// https://fmt.dev/papers/Schubfach4.pdf.
+// Copyright (c) 2025 - present, Victor Zverovich
+// Distributed under the MIT license (see LICENSE).
+//
+// The structure follows schubfach.cc. With at most 11-bit significands,
+// 64-bit powers of 10 are more than precise enough and the whole computation
+// fits in one 64x64->128-bit multiplication per bound. The table of powers
+// is computed at compile time.
+
+#include "schubfach_16.h"
+
+#include <string.h>  // memcpy
+
+#include <bit>  // std::countl_zero
+
+#ifdef __SIZEOF_INT128__
+
+namespace {
+
+using uint128_t = unsigned __int128;
+
+// A 64-bit overestimate of a power of 10, exact if 10**e fits:
+//   10**e ~ sig * 2**(bin_exp - 63), sig >= 2**63.
+struct pow10_significand {
+  uint64_t sig;
+  int bin_exp;  // floor(log2(10**e))
+};
+
+// Range of powers of 10 used: the decimal exponent of a bfloat16 is in
+// [-41, 36] and that of a binary16 in [-8, 4].
+constexpr int pow10_min = -36;
+constexpr int pow10_max = 41;
+
+// Little-endian 256-bit integer for computing the powers of 10.
+struct uint256 {
+  uint64_t words[4];
+};
+
+constexpr auto bit_length(const uint256& n) -> int {
+  for (int i = 3; i >= 0; --i) {
+    if (n.words[i] != 0) return i * 64 + 64 - std::countl_zero(n.words[i]);
+  }
+  return 0;
+}
+
+// Returns bits [pos, pos + 64) of n; bits below 0 are zero.
+constexpr auto bits_at(const uint256& n, int pos) -> uint64_t {
+  auto word = [&](int i) -> uint64_t {
+    return i >= 0 && i < 4 ? n.words[i] : 0;
+  };
+  int i = pos >> 6, shift = pos & 63;
+  if (shift == 0) return word(i);
+  return (word(i) >> shift) | (word(i + 1) << (64 - shift));
+}
+
+// Returns the top 64 bits of n, rounded up unless n is exact and they are
+// all of its nonzero bits.
+constexpr auto top64(const uint256& n, int bin_exp, bool exact)
+    -> pow10_significand {
+  int pos = bit_length(n) - 64;
+  for (int i = 0; exact && i < pos; i += 64) {
+    int n_bits = pos - i < 64 ? pos - i : 64;
+    if (bits_at(n, i) << (64 - n_bits) != 0) exact = false;
+  }
+  return {bits_at(n, pos) + (exact ? 0 : 1), bin_exp};
+}
+
+constexpr auto make_pow10_significands() {
+  struct table {
+    pow10_significand data[pow10_max - pow10_min + 1];
+  } t = {};
+  uint256 n = {{1, 0, 0, 0}};
+  for (int e = 0; e <= pow10_max; ++e) {
+    t.data[e - pow10_min] = top64(n, bit_length(n) - 1, true);
+    uint64_t carry = 0;
+    for (uint64_t& word : n.words) {
+      uint128_t product = uint128_t(word) * 10 + carry;
+      word = uint64_t(product);
+      carry = uint64_t(product >> 64);
+    }
+  }
+  // floor(2**m / 10**-e) has the same top bits as 10**e * 2**m.
+  constexpr int m = 192;
+  n = {{0, 0, 0, 1}};
+  for (int e = -1; e >= pow10_min; --e) {
+    uint64_t rem = 0;
+    for (int i = 3; i >= 0; --i) {
+      uint128_t dividend = (uint128_t(rem) << 64) | n.words[i];
+      n.words[i] = uint64_t(dividend / 10);
+      rem = uint64_t(dividend % 10);
+    }
+    t.data[e - pow10_min] = top64(n, bit_length(n) - 1 - m, false);
+  }
+  return t;
+}
+constexpr auto pow10_significands = make_pow10_significands();
+
+// Divisors 5**k for exact division: x is a multiple of 5**k iff
+// x * inverse <= limit modulo 2**64, and then the product is x / 5**k.
+struct pow5_divisor {
+  uint64_t inverse;  // 5**-k modulo 2**64
+  uint64_t limit;    // floor((2**64 - 1) / 5**k)
+};
+
+// The scaled significand and boundaries are less than 2**13 + 3 < 5**6.
+constexpr int max_pow5_divisor = 5;
+
+constexpr auto make_pow5_divisors() {
+  struct table {
+    pow5_divisor data[max_pow5_divisor + 1];
+  } t = {};
+  // Newton's iteration doubles the number of correct low bits of 5**-1.
+  uint64_t inverse5 = 5;
+  for (int i = 0; i < 5; ++i) inverse5 *= 2 - 5 * inverse5;
+  uint64_t pow5 = 1, inverse = 1;
+  for (int k = 0; k <= max_pow5_divisor; ++k) {
+    t.data[k] = {inverse, ~uint64_t() / pow5};
+    pow5 *= 5;
+    inverse *= inverse5;
+  }
+  return t;
+}
+constexpr auto pow5_divisors = make_pow5_divisors();
+
+// log10_2_sig = round(log10(2) * 2**log10_2_exp)
+constexpr int64_t log10_2_sig = 661'971'961'083;
+constexpr int log10_2_exp = 41;
+
+// Writes the decimal FP number dec_sig * 10**dec_exp to buffer as
+// d[.ddd]E[-]x and returns a pointer to one past the last character written.
+char* write(char* buffer, uint32_t dec_sig, int dec_exp) noexcept {
+  while (dec_sig % 10 == 0) {
+    dec_sig /= 10;
+    ++dec_exp;
+  }
+  char digits[8];
+  int len = 0;
+  do {
+    digits[len++] = char('0' + dec_sig % 10);
+    dec_sig /= 10;
+  } while (dec_sig != 0);
+  dec_exp += len - 1;
+
+  *buffer++ = digits[len - 1];
+  if (len > 1) {
+    *buffer++ = '.';
+    for (int i = len - 2; i >= 0; --i) *buffer++ = digits[i];
+  }
+  *buffer++ = 'E';
+  if (dec_exp < 0) {
+    *buffer++ = '-';
+    dec_exp = -dec_exp;
+  }
+  if (dec_exp >= 10) *buffer++ = char('0' + dec_exp / 10);
+  *buffer++ = char('0' + dec_exp % 10);
+  return buffer;
+}
+
+template <int num_sig_bits, int num_exp_bits>
+char* to_chars(uint16_t bits, char* buffer) noexcept {
+  constexpr int exp_mask = (1 << num_exp_bits) - 1;
+  constexpr int exp_bias = (1 << (num_exp_bits - 1)) - 1;
+  constexpr uint32_t implicit_bit = uint32_t(1) << num_sig_bits;
+  int bin_exp = (bits >> num_sig_bits) & exp_mask;
+  uint32_t bin_sig = bits & (implicit_bit - 1);  // binary significand
+
+  if (bin_exp == exp_mask) [[unlikely]] {
+    if (bin_sig != 0) {
+      memcpy(buffer, "NaN", 3);
+      return buffer + 3;
+    }
+    *buffer = '-';
+    buffer += bits >> 15;
+    memcpy(buffer, "Infinity", 8);
+    return buffer + 8;
+  }
+  *buffer = '-';
+  buffer += bits >> 15;
+  if (bin_exp == 0 && bin_sig == 0) [[unlikely]] {
+    memcpy(buffer, "0E0", 3);
+    return buffer + 3;
+  }
+
+  bool regular = bin_sig != 0 || bin_exp <= 1;
+  if (bin_exp == 0)
+    bin_exp = 1;  // Subnormal.
+  else
+    bin_sig |= implicit_bit;
+  bin_exp -= num_sig_bits + exp_bias;  // Remove the exponent bias.
+
+  // Shift the significand so that boundaries are integer.
+  uint64_t bin_sig_shifted = uint64_t(bin_sig) << 2;
+
+  // Compute the shifted boundaries of the rounding interval (Rv).
+  uint64_t lower = bin_sig_shifted - (regular ? 2 : 1);
+  uint64_t upper = bin_sig_shifted + 2;
+
+  // log10_3_over_4_sig = round(log10(3/4) * 2**log10_2_exp)
+  constexpr int64_t log10_3_over_4_sig = -274'743'187'321;
+
+  // Compute the decimal exponent as floor(log10(2**bin_exp)) if regular or
+  // floor(log10(3/4 * 2**bin_exp)) otherwise.
+  int dec_exp = (bin_exp * log10_2_sig + (!regular ? log10_3_over_4_sig : 0)) >>
+                log10_2_exp;
+
+  const pow10_significand& pow10 =
+      pow10_significands.data[-dec_exp - pow10_min];
+  int shift = bin_exp + pow10.bin_exp + 2;
+
+  // Computes x * 2**bin_exp / 10**dec_exp with 2 fractional bits and
+  // modified rounding (round to odd). Negative powers of 10 are
+  // overestimated, so exact results are detected by divisibility by
+  // 5**dec_exp, see schubfach_ld.cc.
+  auto scale = [&](uint64_t x) -> uint64_t {
+    if (dec_exp > 0 && dec_exp <= max_pow5_divisor) {
+      const pow5_divisor& d = pow5_divisors.data[dec_exp];
+      uint64_t quotient = x * d.inverse;
+      if (quotient <= d.limit) return quotient << (bin_exp - dec_exp);
+    }
+    uint128_t p = uint128_t(pow10.sig) * (x << shift);
+    constexpr uint128_t mask = (uint128_t(1) << 65) - 1;
+    return uint64_t(p >> 65) | ((p & mask) != 0 ? 1 : 0);
+  };
+
+  uint64_t scaled_sig = scale(bin_sig_shifted);
+  lower = scale(lower);
+  upper = scale(upper);
+
+  uint64_t dec_sig_under = scaled_sig >> 2;
+  uint64_t bin_sig_lsb = bin_sig & 1;
+  if (dec_sig_under >= 10) {
+    // Compute the significands of the under- and overestimate.
+    uint64_t dec_sig_under2 = 10 * (dec_sig_under / 10);
+    uint64_t dec_sig_over2 = dec_sig_under2 + 10;
+    // Check if the under- and overestimates are in the interval.
+    bool under_in = lower + bin_sig_lsb <= (dec_sig_under2 << 2);
+    bool over_in = (dec_sig_over2 << 2) + bin_sig_lsb <= upper;
+    if (under_in != over_in) {
+      return write(buffer, uint32_t(under_in ? dec_sig_under2 : dec_sig_over2),
+                   dec_exp);
+    }
+  }
+
+  uint64_t dec_sig_over = dec_sig_under + 1;
+  bool under_in = lower + bin_sig_lsb <= (dec_sig_under << 2);
+  bool over_in = (dec_sig_over << 2) + bin_sig_lsb <= upper;
+  if (under_in != over_in) {
+    // Only one of dec_sig_under or dec_sig_over are in the rounding interval.
+    return write(buffer, uint32_t(under_in ? dec_sig_under : dec_sig_over),
+                 dec_exp);
+  }
+
+  // Both dec_sig_under and dec_sig_over are in the interval - pick the closest.
+  int cmp = int(scaled_sig - ((dec_sig_under + dec_sig_over) << 1));
+  bool under_closer = cmp < 0 || (cmp == 0 && (dec_sig_under & 1) == 0);
+  return write(buffer, uint32_t(under_closer ? dec_sig_under : dec_sig_over),
+               dec_exp);
+}
+
+}  // namespace
+
+char* schubfach::binary16_to_chars(uint16_t bits, char* buffer) noexcept {
+  return to_chars<10, 5>(bits, buffer);
+}
+
+char* schubfach::bfloat16_to_chars(uint16_t bits, char* buffer) noexcept {
+  return to_chars<7, 8>(bits, buffer);
+}
+
+#endif  // __SIZEOF_INT128__
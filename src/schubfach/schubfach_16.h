@@ -0,0 +1,19 @@
+// Schubfach for the 16-bit formats IEEE 754 binary16 and bfloat16.
+// Copyright (c) 2025 - present, Victor Zverovich
+// Distributed under the MIT license (see LICENSE).
+
+#include <stdint.h>  // uint16_t
+
+namespace schubfach {
+
+constexpr int half_buffer_size = 16;
+
+/// Writes the shortest correctly rounded decimal representation of the
+/// binary16 or bfloat16 value with the given bits to `buffer` in the format
+/// of ryu's generic_to_chars, e.g. 1.5E-3. `buffer` should point to a buffer
+/// of size `half_buffer_size` or larger. Returns a pointer to one past the
+/// last character written.
+char* binary16_to_chars(uint16_t bits, char* buffer) noexcept;
+char* bfloat16_to_chars(uint16_t bits, char* buffer) noexcept;
+
+}  // namespace schubfach
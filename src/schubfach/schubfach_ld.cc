@@ -0,0 +1,354 @@
+// Extension of the Schubfach algorithm to the x87 80-bit long double:
+// https://fmt.dev/papers/Schubfach4.pdf.
+// Copyright (c) 2025 - present, Victor Zverovich
+// Distributed under the MIT license (see LICENSE).
+//
+// The structure follows schubfach.cc with wider integers: the 64-bit
+// significand shifted for the rounding interval needs up to 75 bits, so it is
+// multiplied by 192-bit powers of 10 and the decimal significand, up to 21
+// digits, is kept in 128 bits. The powers of 10 span 9864 decimal exponents;
+// rather than checking in a 300KB generated table, they are computed once on
+// first use with exact big integer arithmetic.
+
+#include "schubfach_ld.h"
+
+#include <float.h>   // LDBL_MANT_DIG
+#include <stdint.h>  // uint64_t
+#include <string.h>  // memcpy
+
+#include <algorithm>  // std::max
+#include <bit>        // std::countl_zero
+#include <vector>     // std::vector
+
+#if LDBL_MANT_DIG == 64 && defined(__SIZEOF_INT128__)
+
+namespace {
+
+using uint128_t = unsigned __int128;
+
+// A 192-bit overestimate of a power of 10:
+//   10**e ~ (hi:mid:lo) * 2**(bin_exp - 191), hi >= 2**63.
+struct pow10_significand {
+  uint64_t hi;
+  uint64_t mid;
+  uint64_t lo;
+  int bin_exp;  // floor(log2(10**e))
+};
+
+// Range of decimal exponents e such that 10**e is used. The decimal exponent
+// of a long double is in [-4951, 4912] and the power used is its negation.
+constexpr int pow10_min = -4912;
+constexpr int pow10_max = 4951;
+
+// Little-endian big integer.
+using bigint = std::vector<uint64_t>;
+
+auto bit_length(const bigint& n) -> int {
+  return int(n.size()) * 64 - std::countl_zero(n.back());
+}
+
+// Returns bits [pos, pos + 64) of n; bits below 0 are zero.
+auto bits_at(const bigint& n, int pos) -> uint64_t {
+  auto word = [&](int i) -> uint64_t {
+    return i >= 0 && i < int(n.size()) ? n[i] : 0;
+  };
+  int i = pos >> 6, shift = pos & 63;
+  if (shift == 0) return word(i);
+  return (word(i) >> shift) | (word(i + 1) << (64 - shift));
+}
+
+// Returns the top 192 bits of n, rounded up unless n is exact and they are
+// all of its nonzero bits.
+auto top192(const bigint& n, int bin_exp, bool exact) -> pow10_significand {
+  int pos = bit_length(n) - 192;
+  pow10_significand s = {bits_at(n, pos + 128), bits_at(n, pos + 64),
+                         bits_at(n, pos), bin_exp};
+  for (int i = 0; exact && i < pos; i += 64) {
+    if (bits_at(n, i) << std::max(64 - (pos - i), 0) != 0) exact = false;
+  }
+  if (!exact && ++s.lo == 0 && ++s.mid == 0) ++s.hi;
+  return s;
+}
+
+auto compute_pow10_significands() -> std::vector<pow10_significand> {
+  std::vector<pow10_significand> table(pow10_max - pow10_min + 1);
+
+  // Nonnegative powers: 10**e exactly.
+  bigint n = {1};
+  for (int e = 0; e <= pow10_max; ++e) {
+    table[e - pow10_min] = top192(n, bit_length(n) - 1, true);
+    uint64_t carry = 0;
+    for (uint64_t& word : n) {
+      uint128_t product = uint128_t(word) * 10 + carry;
+      word = uint64_t(product);
+      carry = uint64_t(product >> 64);
+    }
+    if (carry != 0) n.push_back(carry);
+  }
+
+  // Negative powers: floor(2**m / 10**-e), which has the same top bits as
+  // 10**e * 2**m since floor(floor(x) / 2**k) = floor(x / 2**k). m leaves
+  // more than 192 bits for the smallest power.
+  constexpr int m = 64 * 262;
+  n.assign(m / 64 + 1, 0);
+  n.back() = 1;
+  for (int e = -1; e >= pow10_min; --e) {
+    uint64_t rem = 0;
+    for (size_t i = n.size(); i-- > 0;) {
+      uint128_t dividend = (uint128_t(rem) << 64) | n[i];
+      n[i] = uint64_t(dividend / 10);
+      rem = uint64_t(dividend % 10);
+    }
+    if (n.back() == 0) n.pop_back();
+    table[e - pow10_min] = top192(n, bit_length(n) - 1 - m, false);
+  }
+  return table;
+}
+
+auto pow10_significands() -> const pow10_significand* {
+  static const std::vector<pow10_significand> table =
+      compute_pow10_significands();
+  return table.data();
+}
+
+// Computes the upper bits of x * (hi:mid:lo) / 2**193 with modified rounding
+// (round to odd), the 192-bit counterpart of umul192_upper64_modified.
+auto umul320_upper128_modified(const pow10_significand& pow10,
+                               uint128_t x) noexcept -> uint128_t {
+  uint64_t x_lo = uint64_t(x), x_hi = uint64_t(x >> 64);
+  uint128_t a0 = uint128_t(pow10.lo) * x_lo;
+  uint128_t a1 = uint128_t(pow10.mid) * x_lo;
+  uint128_t a2 = uint128_t(pow10.hi) * x_lo;
+  uint128_t b0 = uint128_t(pow10.lo) * x_hi;
+  uint128_t b1 = uint128_t(pow10.mid) * x_hi;
+  uint128_t b2 = uint128_t(pow10.hi) * x_hi;
+  uint64_t p0 = uint64_t(a0);
+  uint128_t sum = (a0 >> 64) + uint64_t(a1) + uint64_t(b0);
+  uint64_t p1 = uint64_t(sum);
+  sum = (sum >> 64) + (a1 >> 64) + uint64_t(a2) + (b0 >> 64) + uint64_t(b1);
+  uint64_t p2 = uint64_t(sum);
+  sum = (sum >> 64) + (a2 >> 64) + (b1 >> 64) + b2;
+  // x < 2**76, so the product has less than 2**268 and sum fits in 76 bits.
+  uint128_t result = sum >> 1;
+  // OR with 1 if the product is not divisible by 2**193.
+  return result | ((uint64_t(sum) & 1) | p2 | p1 | p0 ? 1 : 0);
+}
+
+// Divisors 5**k for exact division: x is a multiple of 5**k iff
+// x * inverse <= limit modulo 2**128, and then the product is x / 5**k.
+struct pow5_divisor {
+  uint128_t inverse;  // 5**-k modulo 2**128
+  uint128_t limit;    // floor((2**128 - 1) / 5**k)
+};
+
+// The scaled significand and boundaries are less than 2**66 + 3 < 5**29.
+constexpr int max_pow5_divisor = 28;
+
+constexpr auto make_pow5_divisors() {
+  struct table {
+    pow5_divisor data[max_pow5_divisor + 1];
+  } t = {};
+  // Newton's iteration doubles the number of correct low bits of 5**-1.
+  uint128_t inverse5 = 5;
+  for (int i = 0; i < 6; ++i) inverse5 *= 2 - 5 * inverse5;
+  uint128_t pow5 = 1, inverse = 1;
+  for (int k = 0; k <= max_pow5_divisor; ++k) {
+    t.data[k] = {inverse, ~uint128_t() / pow5};
+    pow5 *= 5;
+    inverse *= inverse5;
+  }
+  return t;
+}
+constexpr auto pow5_divisors = make_pow5_divisors();
+
+// log10_2_sig = round(log10(2) * 2**log10_2_exp)
+constexpr int64_t log10_2_sig = 661'971'961'083;
+constexpr int log10_2_exp = 41;
+
+// Computes floor(log10(pow(2, e))) for e <= 5456721.
+auto floor_log10_pow2(int e) noexcept -> int {
+  return e * log10_2_sig >> log10_2_exp;
+}
+
+constexpr auto make_pow10() {
+  struct table {
+    uint128_t data[22];
+  } t = {};
+  t.data[0] = 1;
+  for (int i = 1; i < 22; ++i) t.data[i] = t.data[i - 1] * 10;
+  return t;
+}
+constexpr auto pow10 = make_pow10();
+
+auto write8digits(char* buffer, unsigned n) noexcept -> char* {
+  // Based on Division-Free Binary-to-Decimal Conversion:
+  // https://inria.hal.science/hal-00864293/.
+  constexpr int shift = 28;
+  constexpr uint64_t magic = 193'428'131'138'340'668;
+  unsigned y = uint64_t((uint128_t((uint64_t(n) + 1) << shift) * magic) >>
+                        84) -
+               1;
+  for (int i = 0; i < 8; ++i) {
+    unsigned t = 10 * y;
+    *buffer++ = '0' + (t >> shift);
+    y = t & ((1 << shift) - 1);
+  }
+  return buffer;
+}
+
+// Writes the decimal FP number dec_sig * 10**dec_exp to buffer as
+// d[.ddd]E[-]x and returns a pointer to one past the last character written.
+char* write(char* buffer, uint128_t dec_sig, int dec_exp) noexcept {
+  uint64_t sig_hi = uint64_t(dec_sig >> 64);
+  int bits = sig_hi != 0 ? 128 - std::countl_zero(sig_hi)
+                         : 64 - std::countl_zero(uint64_t(dec_sig));
+  int len = floor_log10_pow2(bits);
+  if (dec_sig >= pow10.data[len]) ++len;
+  constexpr int max_digits = 21;
+  dec_sig *= pow10.data[max_digits - len];
+  dec_exp += len - 1;
+
+  // dec_sig < 10**21 < 2**70, so the top 5 digits are
+  // floor(floor(dec_sig / 2**16) / (10**16 / 2**16)) in 64-bit arithmetic.
+  constexpr uint64_t pow10_16 = 10'000'000'000'000'000;
+  uint64_t hi = uint64_t(dec_sig >> 16) / (pow10_16 >> 16);
+  uint64_t lo = uint64_t(dec_sig) - hi * pow10_16;
+
+  unsigned top = unsigned(hi);
+  *buffer++ = '0' + top / 10'000;
+  char* point = buffer;
+  *buffer++ = '.';
+  top %= 10'000;
+  buffer[0] = '0' + top / 1000;
+  buffer[1] = '0' + top / 100 % 10;
+  buffer[2] = '0' + top / 10 % 10;
+  buffer[3] = '0' + top % 10;
+  buffer += 4;
+  constexpr unsigned pow10_8 = 100'000'000;
+  buffer = write8digits(buffer, unsigned(lo / pow10_8));
+  buffer = write8digits(buffer, unsigned(lo % pow10_8));
+
+  // Remove trailing zeros and the point if no digits are left after it.
+  while (buffer[-1] == '0') --buffer;
+  if (buffer == point + 1) buffer = point;
+
+  *buffer++ = 'E';
+  if (dec_exp < 0) {
+    *buffer++ = '-';
+    dec_exp = -dec_exp;
+  }
+  int exp_len = dec_exp >= 1000 ? 4 : dec_exp >= 100 ? 3 : dec_exp >= 10 ? 2
+                                                                          : 1;
+  for (int i = exp_len - 1; i >= 0; --i) {
+    buffer[i] = '0' + dec_exp % 10;
+    dec_exp /= 10;
+  }
+  return buffer + exp_len;
+}
+
+}  // namespace
+
+char* schubfach::ldtoa(long double value, char* buffer) noexcept {
+  // x87 layout: 64-bit significand with an explicit integer bit, then a
+  // 15-bit biased exponent and the sign.
+  uint64_t bin_sig = 0;
+  uint16_t sign_exp = 0;
+  memcpy(&bin_sig, &value, sizeof(bin_sig));
+  memcpy(&sign_exp, reinterpret_cast<const char*>(&value) + sizeof(bin_sig),
+         sizeof(sign_exp));
+
+  constexpr int exp_mask = 0x7fff;
+  int bin_exp = sign_exp & exp_mask;
+  uint64_t fraction = bin_sig << 1;
+  if (bin_exp == exp_mask) [[unlikely]] {
+    if (fraction != 0) {
+      memcpy(buffer, "NaN", 3);
+      return buffer + 3;
+    }
+    *buffer = '-';
+    buffer += sign_exp >> 15;
+    memcpy(buffer, "Infinity", 8);
+    return buffer + 8;
+  }
+  *buffer = '-';
+  buffer += sign_exp >> 15;
+  if (bin_sig == 0) [[unlikely]] {
+    memcpy(buffer, "0E0", 3);
+    return buffer + 3;
+  }
+
+  // The interval is asymmetric only for powers of 2 above the subnormal
+  // range, which share the spacing of the subnormals.
+  bool regular = fraction != 0 || bin_exp <= 1;
+  if (bin_exp == 0) bin_exp = 1;  // Subnormal.
+  constexpr int num_sig_bits = 63;
+  bin_exp -= num_sig_bits + 16383;  // Remove the exponent bias.
+
+  // Shift the significand so that boundaries are integer.
+  uint128_t bin_sig_shifted = uint128_t(bin_sig) << 2;
+
+  // Compute the shifted boundaries of the rounding interval (Rv).
+  uint128_t lower = bin_sig_shifted - (regular ? 2 : 1);
+  uint128_t upper = bin_sig_shifted + 2;
+
+  // log10_3_over_4_sig = round(log10(3/4) * 2**log10_2_exp)
+  constexpr int64_t log10_3_over_4_sig = -274'743'187'321;
+
+  // Compute the decimal exponent as floor(log10(2**bin_exp)) if regular or
+  // floor(log10(3/4 * 2**bin_exp)) otherwise.
+  int dec_exp = (bin_exp * log10_2_sig + (!regular ? log10_3_over_4_sig : 0)) >>
+                log10_2_exp;
+
+  const pow10_significand& pow10 = pow10_significands()[-dec_exp - pow10_min];
+
+  // Shift to ensure the intermediate result in umul320_upper128_modified has
+  // a fixed fractional width, see schubfach.cc.
+  int shift = bin_exp + pow10.bin_exp + 2;
+
+  // Negative powers of 10 are overestimated, so the modified rounding can't
+  // tell if x * 2**bin_exp / 10**dec_exp is an integer. For dec_exp > 0 it is
+  // one iff 5**dec_exp divides x; nonnegative powers that matter are exact.
+  auto scale = [&](uint128_t x) -> uint128_t {
+    if (dec_exp > 0 && dec_exp <= max_pow5_divisor) {
+      const pow5_divisor& d = pow5_divisors.data[dec_exp];
+      uint128_t quotient = x * d.inverse;
+      if (quotient <= d.limit) return quotient << (bin_exp - dec_exp);
+    }
+    return umul320_upper128_modified(pow10, x << shift);
+  };
+
+  uint128_t scaled_sig = scale(bin_sig_shifted);
+
+  // Compute the estimates of lower and upper bounds of the rounding interval
+  // by multiplying them by the power of 10 and applying modified rounding.
+  lower = scale(lower);
+  upper = scale(upper);
+
+  uint128_t dec_sig_under = scaled_sig >> 2;
+  unsigned bin_sig_lsb = bin_sig & 1;
+  if (dec_sig_under >= 10) {
+    // Compute the significands of the under- and overestimate.
+    uint128_t dec_sig_under2 = 10 * (dec_sig_under / 10);
+    uint128_t dec_sig_over2 = dec_sig_under2 + 10;
+    // Check if the under- and overestimates are in the interval.
+    bool under_in = lower + bin_sig_lsb <= (dec_sig_under2 << 2);
+    bool over_in = (dec_sig_over2 << 2) + bin_sig_lsb <= upper;
+    if (under_in != over_in)
+      return write(buffer, under_in ? dec_sig_under2 : dec_sig_over2, dec_exp);
+  }
+
+  uint128_t dec_sig_over = dec_sig_under + 1;
+  bool under_in = lower + bin_sig_lsb <= (dec_sig_under << 2);
+  bool over_in = (dec_sig_over << 2) + bin_sig_lsb <= upper;
+  if (under_in != over_in) {
+    // Only one of dec_sig_under or dec_sig_over are in the rounding interval.
+    return write(buffer, under_in ? dec_sig_under : dec_sig_over, dec_exp);
+  }
+
+  // Both dec_sig_under and dec_sig_over are in the interval - pick the closest.
+  auto cmp = int64_t(scaled_sig - ((dec_sig_under + dec_sig_over) << 1));
+  bool under_closer = cmp < 0 || (cmp == 0 && (dec_sig_under & 1) == 0);
+  return write(buffer, under_closer ? dec_sig_under : dec_sig_over, dec_exp);
+}
+
+#endif  // LDBL_MANT_DIG == 64 && defined(__SIZEOF_INT128__)
@@ -0,0 +1,16 @@
+// Extension of the Schubfach algorithm to the x87 80-bit long double.
+// Copyright (c) 2025 - present, Victor Zverovich
+// Distributed under the MIT license (see LICENSE).
+
+namespace schubfach {
+
+constexpr int ld_buffer_size = 29;
+
+/// Writes the shortest correctly rounded decimal representation of `value` to
+/// `buffer` in the format of ryu's generic_to_chars, e.g. 1.5E-3. Requires a
+/// 64-bit long double significand. `buffer` should point to a buffer of size
+/// `ld_buffer_size` or larger. Returns a pointer to one past the last
+/// character written.
+char* ldtoa(long double value, char* buffer) noexcept;
+
+}  // namespace schubfach
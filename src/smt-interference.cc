@@ -0,0 +1,210 @@
+// SMT sibling interference test for dtoa implementations.
+//
+// cache-contention interleaves the competitor with dtoa calls on one thread.
+// In production the competitor (e.g. the order book) often runs on the
+// hyperthread sibling instead and competes for execution ports as well as
+// L1/L2. This tool pins the dtoa loop to one logical CPU and a competitor to
+// its sibling and reports per-method slowdown for three kinds of competitor:
+//
+//   memory - random reads over a buffer larger than L2 (load ports, L1/L2)
+//   alu    - independent integer multiply/add chains (scalar ALU ports)
+//   simd   - vector multiply/add over registers (vector ALU ports)
+//
+// Usage: ./smt-interference [method] [rounds] [memory|alu|simd]
+
+#include "cpu-topology.h"
+#include "tool-methods.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Returns the first pair of logical CPUs sharing a core, or {-1, -1}.
+static auto find_siblings() -> std::pair<int, int> {
+  for (int cpu = 0; cpu < 4096; cpu++) {
+    auto path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                "/topology/thread_siblings_list";
+    std::vector<int> siblings = read_cpu_list(path);
+    if (siblings.empty() && cpu >= int(std::thread::hardware_concurrency()))
+      break;
+    for (int sibling : siblings) {
+      if (sibling != cpu) return {cpu, sibling};
+    }
+  }
+  return {-1, -1};
+}
+
+static std::atomic<bool> stop_competitor;
+static volatile uint64_t competitor_sink;
+
+// 8MB: larger than L2 on current x86 and Arm server cores.
+static constexpr size_t MEMORY_COMPETITOR_WORDS = (8 << 20) / sizeof(uint64_t);
+static std::vector<uint64_t> memory_competitor;
+
+static void run_memory_competitor() {
+  uint64_t x = 0x9e3779b97f4a7c15ULL, sum = 0;
+  size_t mask = MEMORY_COMPETITOR_WORDS - 1;
+  while (!stop_competitor.load(std::memory_order_relaxed)) {
+    for (int i = 0; i < 1024; i++) {
+      x ^= x << 13, x ^= x >> 7, x ^= x << 17;  // xorshift64
+      sum += memory_competitor[x & mask];
+    }
+  }
+  competitor_sink = sum;
+}
+
+static void run_alu_competitor() {
+  uint64_t a = 1, b = 2, c = 3, d = 4;
+  while (!stop_competitor.load(std::memory_order_relaxed)) {
+    for (int i = 0; i < 1024; i++) {
+      a = a * 0x9e3779b97f4a7c15ULL + 1;
+      b = b * 0xbf58476d1ce4e5b9ULL + 3;
+      c += c >> 3 ^ a;
+      d += d << 1 ^ b;
+    }
+  }
+  competitor_sink = a + b + c + d;
+}
+
+static void run_simd_competitor() {
+  // GCC/Clang vector extensions: compiled to the widest enabled vector unit.
+  typedef double v4d __attribute__((vector_size(32)));
+  v4d acc[8];
+  for (int j = 0; j < 8; j++) acc[j] = v4d{1.0 + j, 2.0, 3.0, 4.0};
+  const v4d mul = {0.999999, 0.999998, 0.999997, 0.999996};
+  const v4d add = {1e-7, 2e-7, 3e-7, 4e-7};
+  while (!stop_competitor.load(std::memory_order_relaxed)) {
+    for (int i = 0; i < 1024; i++) {
+      for (int j = 0; j < 8; j++) acc[j] = acc[j] * mul + add;
+    }
+  }
+  double sum = 0;
+  for (int j = 0; j < 8; j++) sum += acc[j][0] + acc[j][3];
+  competitor_sink = uint64_t(sum);
+}
+
+struct competitor {
+  const char* name;
+  void (*run)();
+};
+
+static const competitor competitors[] = {
+    {"memory", run_memory_competitor},
+    {"alu", run_alu_competitor},
+    {"simd", run_simd_competitor},
+};
+
+// Returns nanoseconds per dtoa call on the current thread.
+static double __attribute__((noinline))
+measure(dtoa_fun dtoa, int rounds) {
+  char buffer[256];
+  for (int i = 0; i < NUM_TEST_VALUES; i++) dtoa(test_values[i], buffer);
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < NUM_TEST_VALUES; i++) dtoa(test_values[i], buffer);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double total_ns = std::chrono::duration<double, std::nano>(end - start).count();
+  return total_ns / (double(rounds) * NUM_TEST_VALUES);
+}
+
+// Best of 3 runs of `dtoa` while `c` (if any) runs on `sibling`.
+static double measure_with(dtoa_fun dtoa, int rounds, const competitor* c,
+                           int sibling) {
+  std::thread thread;
+  if (c) {
+    stop_competitor = false;
+    thread = std::thread([c, sibling]() {
+      pin_to_cpu(sibling);
+      c->run();
+    });
+    // Give the competitor time to get scheduled and warm up.
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  double ns = measure(dtoa, rounds);
+  for (int retry = 0; retry < 2; retry++) ns = std::min(ns, measure(dtoa, rounds));
+  if (c) {
+    stop_competitor = true;
+    thread.join();
+  }
+  return ns;
+}
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  int rounds = argc > 2 ? atoi(argv[2]) : 5000;
+  const char* competitor_filter = argc > 3 ? argv[3] : nullptr;
+
+  auto [cpu, sibling] = find_siblings();
+  if (cpu < 0) {
+    fprintf(stderr, "error: no SMT siblings found (SMT disabled?)\n");
+    return 1;
+  }
+  if (!pin_to_cpu(cpu)) {
+    fprintf(stderr, "error: cannot pin to CPU %d\n", cpu);
+    return 1;
+  }
+
+  init_test_values();
+  memory_competitor.resize(MEMORY_COMPETITOR_WORDS);
+  for (size_t i = 0; i < MEMORY_COMPETITOR_WORDS; i++)
+    memory_competitor[i] = i * 0x9e3779b97f4a7c15ULL;
+
+  std::vector<const competitor*> active;
+  for (const competitor& c : competitors) {
+    if (!competitor_filter || strcmp(c.name, competitor_filter) == 0)
+      active.push_back(&c);
+  }
+  if (active.empty()) {
+    fprintf(stderr, "error: unknown competitor '%s'\n", competitor_filter);
+    return 1;
+  }
+
+  std::sort(methods.begin(), methods.end(),
+            [](const method& a, const method& b) { return a.name < b.name; });
+
+  int name_width = 6;
+  for (const auto& m : methods) {
+    int len = static_cast<int>(m.name.size());
+    if (len > name_width) name_width = len;
+  }
+  name_width += 2;
+
+  printf("SMT sibling interference test (dtoa on CPU %d, competitor on CPU %d)\n\n",
+         cpu, sibling);
+  printf("%-*s %8s", name_width, "Method", "alone");
+  for (const competitor* c : active) printf(" %8s %7s", c->name, "slowdwn");
+  printf("\n%-*s %8s", name_width, "------", "--------");
+  for (size_t i = 0; i < active.size(); i++) printf(" %8s %7s", "--------", "-------");
+  printf("\n");
+
+  for (const auto& m : methods) {
+    if (m.name == "null" || m.name == "ostringstream" || m.name == "sprintf")
+      continue;
+    if (filter && m.name != filter) continue;
+
+    printf("%-*s", name_width, m.name.c_str());
+    fflush(stdout);
+    double alone = measure_with(m.dtoa, rounds, nullptr, sibling);
+    printf(" %6.1fns", alone);
+    fflush(stdout);
+    for (const competitor* c : active) {
+      double ns = measure_with(m.dtoa, rounds, c, sibling);
+      printf(" %6.1fns %6.0f%%", ns, (ns / alone - 1.0) * 100.0);
+      fflush(stdout);
+    }
+    printf("\n");
+  }
+
+  printf("\nTime = ns per dtoa call; slowdown vs the sibling being idle\n");
+  return 0;
+}
@@ -4,4 +4,4 @@
 
 static register_method _("sprintf", [](double value, char* buffer) -> char* {
   return buffer + sprintf(buffer, "%.17g", value);
-});
+}, nullptr, 25);
@@ -0,0 +1,173 @@
+#include "table-placement.h"
+
+#include <stdint.h>  // uintptr_t
+#include <stdio.h>   // fopen, sscanf
+#include <string.h>  // memcpy, strcmp
+
+#include <map>
+#include <new>  // std::align_val_t
+#include <vector>
+
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif
+#ifdef __linux__
+#  include <linux/mempolicy.h>  // MPOL_BIND
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+struct table_entry {
+  const char* method;
+  const char* name;
+  const void* data;
+  size_t size;
+  const void** current;
+};
+
+auto tables() -> std::vector<table_entry>& {
+  static std::vector<table_entry> entries;
+  return entries;
+}
+
+constexpr size_t huge_page_size = size_t(2) << 20;
+
+#ifdef __linux__
+// Returns true if the mapping containing `p` is backed by anonymous huge
+// pages according to /proc/self/smaps.
+auto is_thp_backed(const void* p) -> bool {
+  FILE* f = fopen("/proc/self/smaps", "r");
+  if (!f) return false;
+  auto addr = uintptr_t(p);
+  bool in_mapping = false, result = false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long start = 0, end = 0, kb = 0;
+    if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+      in_mapping = addr >= start && addr < end;
+    } else if (in_mapping && sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+      result = kb > 0;
+      break;
+    }
+  }
+  fclose(f);
+  return result;
+}
+#endif
+
+// Binds the not yet faulted-in range [p, p + size) to NUMA `node`. Uses the
+// raw syscall so that libnuma isn't required.
+auto bind_to_node(void* p, size_t size, int node) -> bool {
+#ifdef __linux__
+  unsigned long mask[16] = {};
+  constexpr int max_nodes = int(sizeof(mask) * 8);
+  if (node < 0 || node >= max_nodes) return false;
+  mask[node / 64] |= 1ul << (node % 64);
+  return syscall(SYS_mbind, p, size, MPOL_BIND, mask, max_nodes, 0) == 0;
+#else
+  (void)p, (void)size;
+  return node == 0;
+#endif
+}
+
+// Maps one writable 2MB region, preferring a huge page. If `node` is not
+// negative, the region is bound to that NUMA node; returns null if that fails.
+auto map_huge_page(const char** kind, int node) -> char* {
+#ifndef _WIN32
+#  ifdef MAP_HUGETLB
+  void* p = mmap(nullptr, huge_page_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (p != MAP_FAILED) {
+    *kind = "hugetlb";
+    if (node >= 0 && !bind_to_node(p, huge_page_size, node)) {
+      munmap(p, huge_page_size);
+      return nullptr;
+    }
+    return static_cast<char*>(p);
+  }
+#  endif
+  // No reserved huge pages: map twice the size and keep a 2MB-aligned range
+  // so that a transparent huge page can back it.
+  void* raw = mmap(nullptr, 2 * huge_page_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw != MAP_FAILED) {
+    auto start = uintptr_t(raw);
+    auto aligned = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+    if (aligned > start) munmap(raw, aligned - start);
+    size_t tail = start + 2 * huge_page_size - (aligned + huge_page_size);
+    if (tail > 0) munmap(reinterpret_cast<void*>(aligned + huge_page_size), tail);
+    auto* p = reinterpret_cast<char*>(aligned);
+    *kind = "4k";
+#  ifdef MADV_HUGEPAGE
+    madvise(p, huge_page_size, MADV_HUGEPAGE);
+#  endif
+    if (node >= 0 && !bind_to_node(p, huge_page_size, node)) {
+      munmap(p, huge_page_size);
+      return nullptr;
+    }
+    p[0] = 0;  // Fault the page in.
+#  ifdef __linux__
+    if (is_thp_backed(p)) *kind = "thp";
+#  endif
+    return p;
+  }
+#endif
+  *kind = "4k";
+  if (node > 0) return nullptr;
+  return new (std::align_val_t(4096)) char[huge_page_size];
+}
+
+}  // namespace
+
+relocatable_table::relocatable_table(const char* method, const char* name,
+                                     const void* data, size_t size,
+                                     const void** current) {
+  tables().push_back({method, name, data, size, current});
+}
+
+auto place_tables(table_placement placement, int node) -> const char* {
+  if (placement == table_placement::rodata) {
+    for (const table_entry& t : tables()) *t.current = t.data;
+    return "rodata";
+  }
+
+  // One copy per node (-1 for the unbound huge page), made on first use.
+  struct region {
+    char* page;
+    const char* kind;
+  };
+  static std::map<int, region> regions;
+  if (placement != table_placement::numa_node) node = -1;
+  auto it = regions.find(node);
+  if (it == regions.end()) {
+    const char* kind = nullptr;
+    char* page = map_huge_page(&kind, node);
+    if (!page) return nullptr;
+    size_t offset = 0;
+    for (const table_entry& t : tables()) {
+      if (offset + t.size > huge_page_size) break;
+      memcpy(page + offset, t.data, t.size);
+      offset += (t.size + 63) & ~size_t(63);  // Keep tables line-aligned.
+    }
+#ifndef _WIN32
+    mprotect(page, huge_page_size, PROT_READ);
+#endif
+    it = regions.emplace(node, region{page, kind}).first;
+  }
+  size_t offset = 0;
+  for (const table_entry& t : tables()) {
+    if (offset + t.size > huge_page_size) break;
+    *t.current = it->second.page + offset;
+    offset += (t.size + 63) & ~size_t(63);
+  }
+  return it->second.kind;
+}
+
+auto has_relocatable_tables(const char* method) -> bool {
+  for (const table_entry& t : tables()) {
+    if (strcmp(t.method, method) == 0) return true;
+  }
+  return false;
+}
@@ -0,0 +1,32 @@
+// Run-time placement of conversion tables.
+//
+// Engines normally read their power-of-10 tables straight from .rodata, where
+// they are spread over several 4K pages. The *-relocatable methods read them
+// through a pointer instead, so place_tables() can copy them all into a single
+// 2MB huge page (one dTLB entry), optionally bound to a NUMA node, or point
+// them back at the originals.
+
+#ifndef TABLE_PLACEMENT_H_
+#define TABLE_PLACEMENT_H_
+
+#include <stddef.h>  // size_t
+
+// Registers a table that is read through `*current`, initially `data`.
+struct relocatable_table {
+  relocatable_table(const char* method, const char* name, const void* data,
+                    size_t size, const void** current);
+};
+
+enum class table_placement { rodata, huge_page, numa_node };
+
+// Moves all registered tables and returns a description of where they are:
+// "rodata", "hugetlb" (MAP_HUGETLB), "thp" (transparent huge page, verified
+// in /proc/self/smaps) or "4k" (huge pages unavailable, copied anyway).
+// numa_node places a separate copy in memory bound to `node` (mbind) and
+// returns null if the node can't be bound.
+auto place_tables(table_placement placement, int node = 0) -> const char*;
+
+// Returns true if `method` has tables moved by place_tables().
+auto has_relocatable_tables(const char* method) -> bool;
+
+#endif  // TABLE_PLACEMENT_H_
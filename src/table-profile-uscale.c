@@ -0,0 +1,30 @@
+// uscale compiled a second time for table-profile, which replays the pow10Tab
+// index of each value and checks it here against the engine: the row is
+// cleared, which changes the output of a conversion that reads it. The
+// vendored source is used unmodified; the entry point is renamed to
+// table_profile_uscale_short.
+
+#ifdef __SIZEOF_INT128__
+#  define uscale_short table_profile_uscale_short
+#  include "uscale/uscale.c"
+
+int uscale_reads_pow10(double value, int p) {
+  if (p < pow10Min || p > pow10Max) return 0;
+  char expected[32], actual[32];
+  uscale_short(value, expected);
+  uint64_t* row = pow10Tab[p - pow10Min];
+  uint64_t saved[2] = {row[0], row[1]};
+  row[0] = row[1] = 0;
+  uscale_short(value, actual);
+  row[0] = saved[0];
+  row[1] = saved[1];
+  return strcmp(expected, actual) != 0;
+}
+#else
+// uscale needs unsigned __int128, so its replay isn't checked without it.
+int uscale_reads_pow10(double value, int p) {
+  (void)value;
+  (void)p;
+  return 1;
+}
+#endif
@@ -0,0 +1,334 @@
+// Static-table access profiler for dtoa implementations.
+//
+// Most shortest-dtoa algorithms multiply by a power of 10 looked up in a
+// table indexed by the binary or decimal exponent: dragonbox's full cache,
+// zmij's pow10_significands (plus its exp_shifts byte table), ryu's
+// DOUBLE_POW5_SPLIT / DOUBLE_POW5_INV_SPLIT and uscale's pow10Tab. This tool
+// converts a dataset and records per-entry access counts for each of them,
+// then reports how many cache lines the dataset actually touches and how
+// many a hot subset covering a given share of the accesses would need.
+//
+// dragonbox is profiled by running it with a counting cache policy and ryu by
+// compiling its d2s.c here with the tables read through counting rows. The
+// zmij and uscale tables are internal to their (vendored) translation units,
+// so their index computations are replayed here from the sources and checked
+// against the engines for every value: zmij's decimal exponent against
+// zmij::to_decimal and uscale's row by clearing it in a second copy of uscale
+// (table-profile-uscale.c).
+//
+// With --emit-dragonbox the hot band of the dragonbox cache is written out as
+// a header (src/dragonbox-hot-cache.h, used by the dragonbox-hot method).
+//
+// Usage: ./table-profile [--input=<file of raw doubles>] [--count=N]
+//                        [--coverage=percent] [--emit-dragonbox=<header>]
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>  // std::greater
+#include <numeric>     // std::accumulate
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dragonbox/dragonbox.h"
+#include "profile-data.h"
+#include "ryu/d2s_full_table.h"
+#include "zmij/zmij.h"
+
+// Returns whether uscale reads row p of pow10Tab to convert `value`.
+extern "C" auto uscale_reads_pow10(double value, int p) -> int;
+
+static constexpr int CACHE_LINE_SIZE = 64;
+
+struct table {
+  const char* name;
+  int entry_size;  // In bytes.
+  int first_index;  // Index of the first entry as printed (e.g. min_k).
+  std::vector<uint64_t> counts;
+
+  table(const char* n, int size, int num_entries, int first = 0)
+      : name(n), entry_size(size), first_index(first), counts(num_entries) {}
+
+  auto line(size_t i) const -> size_t { return i * entry_size / CACHE_LINE_SIZE; }
+};
+
+using dragonbox_holder =
+    jkj::dragonbox::cache_holder<jkj::dragonbox::ieee754_binary64>;
+
+static table dragonbox_cache("dragonbox cache", 16,
+                             dragonbox_holder::max_k - dragonbox_holder::min_k + 1,
+                             dragonbox_holder::min_k);
+static table zmij_pow10("zmij pow10_significands", 16, 618, -293);
+static table zmij_exp_shifts("zmij exp_shifts", 1, 2048);
+static table ryu_pow5_inv("ryu DOUBLE_POW5_INV_SPLIT", 16,
+                          DOUBLE_POW5_INV_TABLE_SIZE);
+static table ryu_pow5("ryu DOUBLE_POW5_SPLIT", 16, DOUBLE_POW5_TABLE_SIZE);
+static table uscale_pow10("uscale pow10Tab", 16, 696, -348);
+
+// Same as policy::cache::full but counts the accesses.
+struct counting_cache {
+  using cache_policy = counting_cache;
+  template <class FloatFormat>
+  using cache_holder_type = jkj::dragonbox::cache_holder<FloatFormat>;
+
+  template <class FloatFormat, class ShiftAmountType, class DecimalExponentType>
+  static auto get_cache(DecimalExponentType k) noexcept ->
+      typename cache_holder_type<FloatFormat>::cache_entry_type {
+    using holder = cache_holder_type<FloatFormat>;
+    ++dragonbox_cache.counts[size_t(k - holder::min_k)];
+    return holder::cache[size_t(k - holder::min_k)];
+  }
+};
+
+// Same as a ryu table but counts the accesses.
+struct counting_rows {
+  const uint64_t (*rows)[2];
+  table& t;
+
+  auto operator[](uint32_t i) const -> const uint64_t* {
+    ++t.counts[i];
+    return rows[i];
+  }
+};
+
+static const counting_rows ryu_pow5_inv_rows = {DOUBLE_POW5_INV_SPLIT,
+                                                ryu_pow5_inv};
+static const counting_rows ryu_pow5_rows = {DOUBLE_POW5_SPLIT, ryu_pow5};
+
+// d2s_buffered_n handles integers in [1, 2**53) without tables, d2d indexes
+// the tables by q and i.
+#define DOUBLE_POW5_INV_SPLIT ryu_pow5_inv_rows
+#define DOUBLE_POW5_SPLIT ryu_pow5_rows
+#include "ryu/d2s.c"
+#undef DOUBLE_POW5_INV_SPLIT
+#undef DOUBLE_POW5_SPLIT
+
+// zmij: to_decimal indexes pow10_significands by -dec_exp - 1 and, for
+// regular inputs, exp_shifts by the raw exponent, which is 1 for subnormals.
+// Returns false if the replayed dec_exp differs from zmij's.
+static auto profile_zmij(double value, uint64_t bits) -> bool {
+  int raw_exp = int(bits >> 52);
+  uint64_t bin_sig = bits & ((uint64_t(1) << 52) - 1);
+  if (raw_exp == 0) raw_exp = 1;
+  int bin_exp = raw_exp - 1075;
+  bool regular = bin_sig != 0;
+  int dec_exp = (bin_exp * 315'653 - !regular * 131'072) >> 20;
+  ++zmij_pow10.counts[size_t(-dec_exp - 1 - zmij_pow10.first_index)];
+  if (regular) ++zmij_exp_shifts.counts[size_t(raw_exp)];
+  return zmij::to_decimal(value).exp == dec_exp;
+}
+
+// uscale: Short computes p from the unpacked exponent, prescale indexes
+// pow10Tab by p - pow10Min. Returns false if uscale doesn't read that row.
+static auto profile_uscale(double value, uint64_t bits) -> bool {
+  int raw_exp = int(bits >> 52);
+  uint64_t m = (bits & ((uint64_t(1) << 52) - 1)) << 11;
+  int e = raw_exp - 1086;
+  if (raw_exp == 0) {
+    int s = __builtin_clzll(m);
+    m <<= s;
+    e = -1085 - s;
+  } else {
+    m |= uint64_t(1) << 63;
+  }
+  int b = 11;
+  int p = 0;
+  if (m == uint64_t(1) << 63 && e > -1085) {
+    p = -((((e + b) * 631'305) - 261'663) >> 21);
+  } else {
+    if (e < -1085) b = 11 + (-1085 - e);
+    p = -(((e + b) * 78'913) >> 18);
+  }
+  ++uscale_pow10.counts[size_t(p - uscale_pow10.first_index)];
+  return uscale_reads_pow10(value, p) != 0;
+}
+
+// Smallest contiguous range of entries covering at least `coverage` of the
+// accesses.
+static auto hot_band(const table& t, double coverage) -> std::pair<int, int> {
+  uint64_t total = std::accumulate(t.counts.begin(), t.counts.end(), uint64_t());
+  auto needed = uint64_t(ceil(double(total) * coverage));
+  int n = int(t.counts.size());
+  std::pair<int, int> best = {0, n - 1};
+  uint64_t sum = 0;
+  for (int lo = 0, hi = 0; hi < n; ++hi) {
+    sum += t.counts[hi];
+    while (lo < hi && sum - t.counts[lo] >= needed) sum -= t.counts[lo++];
+    if (sum >= needed && hi - lo < best.second - best.first) best = {lo, hi};
+  }
+  return best;
+}
+
+// Number of cache lines needed if entries are packed hottest first and only
+// those covering `coverage` of the accesses are kept.
+static auto packed_lines(const table& t, double coverage) -> size_t {
+  std::vector<uint64_t> counts = t.counts;
+  std::sort(counts.begin(), counts.end(), std::greater<uint64_t>());
+  uint64_t total = std::accumulate(counts.begin(), counts.end(), uint64_t());
+  auto needed = uint64_t(ceil(double(total) * coverage));
+  size_t entries = 0;
+  for (uint64_t sum = 0; sum < needed; sum += counts[entries++]) {}
+  return (entries * t.entry_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE;
+}
+
+static void print_profile(const table& t, double coverage) {
+  size_t touched = 0, lines_touched = 0;
+  size_t last_line = SIZE_MAX;
+  for (size_t i = 0; i < t.counts.size(); ++i) {
+    if (t.counts[i] == 0) continue;
+    ++touched;
+    if (t.line(i) != last_line) ++lines_touched;
+    last_line = t.line(i);
+  }
+  size_t total_lines = t.line(t.counts.size() - 1) + 1;
+  if (touched == 0) {
+    printf("%-26s %6zu %4zu/%-4zu %4zu/%-4zu %12s %5d %6d\n", t.name,
+           t.counts.size() * t.entry_size, touched, t.counts.size(),
+           lines_touched, total_lines, "-", 0, 0);
+    return;
+  }
+  auto [lo, hi] = hot_band(t, coverage);
+  size_t band_lines = t.line(hi) - t.line(lo) + 1;
+  printf("%-26s %6zu %4zu/%-4zu %4zu/%-4zu %5d..%-5d %5zu %6zu\n", t.name,
+         t.counts.size() * t.entry_size, touched, t.counts.size(),
+         lines_touched, total_lines, lo + t.first_index, hi + t.first_index,
+         band_lines, packed_lines(t, coverage));
+}
+
+static auto emit_dragonbox(const char* path, double coverage,
+                           const std::string& dataset) -> bool {
+  FILE* f = fopen(path, "w");
+  if (!f) return false;
+  auto [lo, hi] = hot_band(dragonbox_cache, coverage);
+  int min_k = lo + dragonbox_holder::min_k, max_k = hi + dragonbox_holder::min_k;
+  fprintf(f,
+          "// Generated by table-profile; do not edit.\n"
+          "//\n"
+          "// Hot subset of the dragonbox binary64 full cache: k in [%d, %d]\n"
+          "// covers %g%% of the cache accesses for %s.\n"
+          "\n"
+          "#ifndef DRAGONBOX_HOT_CACHE_H_\n"
+          "#define DRAGONBOX_HOT_CACHE_H_\n"
+          "\n"
+          "#include <stdint.h>\n"
+          "\n"
+          "namespace dragonbox_hot {\n"
+          "\n"
+          "constexpr int min_k = %d;\n"
+          "constexpr int max_k = %d;\n"
+          "\n"
+          "alignas(64) constexpr uint64_t cache[max_k - min_k + 1][2] = {\n",
+          min_k, max_k, coverage * 100, dataset.c_str(), min_k, max_k);
+  for (int i = lo; i <= hi; ++i) {
+    auto entry = dragonbox_holder::cache[size_t(i)];
+    fprintf(f, "    {0x%016llx, 0x%016llx},  // k = %d\n",
+            (unsigned long long)entry.high(), (unsigned long long)entry.low(),
+            i + dragonbox_holder::min_k);
+  }
+  fprintf(f,
+          "};\n"
+          "\n"
+          "}  // namespace dragonbox_hot\n"
+          "\n"
+          "#endif  // DRAGONBOX_HOT_CACHE_H_\n");
+  return fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+  const char* input = nullptr;
+  const char* emit_path = nullptr;
+  int count = 100'000;
+  double coverage = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg.starts_with("--input=")) {
+      input = argv[i] + strlen("--input=");
+    } else if (arg.starts_with("--count=")) {
+      count = atoi(argv[i] + strlen("--count="));
+    } else if (arg.starts_with("--coverage=")) {
+      coverage = atof(argv[i] + strlen("--coverage=")) / 100;
+    } else if (arg.starts_with("--emit-dragonbox=")) {
+      emit_path = argv[i] + strlen("--emit-dragonbox=");
+    } else {
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (count <= 0 || !(coverage > 0 && coverage <= 1)) {
+    fprintf(stderr, "error: --count must be positive and --coverage in (0, 100]\n");
+    return 1;
+  }
+
+  std::vector<double> values;
+  std::string dataset;
+  if (input) {
+    FILE* f = fopen(input, "rb");
+    if (!f) {
+      fprintf(stderr, "error: cannot open %s\n", input);
+      return 1;
+    }
+    double d = 0;
+    while (fread(&d, sizeof(d), 1, f) == 1) values.push_back(d);
+    fclose(f);
+    dataset = input;
+  } else {
+    values = make_profile_values(count);
+    char buf[128];
+    snprintf(buf, sizeof(buf), "the profile dataset (1-17 digits, 1e%d..1e%d)",
+             profile_min_dec_exp, profile_max_dec_exp);
+    dataset = buf;
+  }
+
+  size_t profiled = 0, zmij_mismatches = 0, uscale_mismatches = 0;
+  for (double value : values) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits &= ~(uint64_t(1) << 63);
+    // Zeros and non-finite values don't touch the tables.
+    if (bits == 0 || (bits >> 52) == 0x7ff) continue;
+    jkj::dragonbox::to_decimal(value, jkj::dragonbox::policy::trailing_zero::ignore,
+                               counting_cache());
+    zmij_mismatches += !profile_zmij(value, bits);
+    char buffer[32];
+    d2s_buffered_n(value, buffer);
+    uscale_mismatches += !profile_uscale(value, bits);
+    ++profiled;
+  }
+  if (zmij_mismatches != 0 || uscale_mismatches != 0) {
+    fprintf(stderr,
+            "error: replayed indexes differ from the engines for %zu (zmij) "
+            "and %zu (uscale) values\n",
+            zmij_mismatches, uscale_mismatches);
+    return 1;
+  }
+
+  printf("Dataset: %s, %zu values (%zu finite nonzero)\n", dataset.c_str(),
+         values.size(), profiled);
+  printf("Hot band and packed lines cover %g%% of the accesses\n\n",
+         coverage * 100);
+  printf("%-26s %6s %9s %9s %12s %5s %6s\n", "Table", "Bytes", "Entries",
+         "Lines", "Hot band", "Lines", "Packed");
+  printf("%-26s %6s %9s %9s %12s %5s %6s\n", "-----", "-----", "-------",
+         "-----", "--------", "-----", "------");
+  for (const table* t : {&dragonbox_cache, &zmij_pow10, &zmij_exp_shifts,
+                         &ryu_pow5_inv, &ryu_pow5, &uscale_pow10}) {
+    print_profile(*t, coverage);
+  }
+  printf("\nEntries/Lines = touched/total (lines assume a line-aligned table)\n");
+  printf("Hot band = smallest contiguous index range covering the accesses\n");
+  printf("Packed = lines needed if the hottest entries are packed together\n");
+
+  if (emit_path) {
+    if (!emit_dragonbox(emit_path, coverage, dataset)) {
+      fprintf(stderr, "error: cannot write %s\n", emit_path);
+      return 1;
+    }
+    printf("\nWrote %s\n", emit_path);
+  }
+  return 0;
+}
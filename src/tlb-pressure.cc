@@ -0,0 +1,164 @@
+// dTLB pressure test for dtoa implementations.
+//
+// Simulates a memory-heavy process whose other work walks a large buffer one
+// 4K page at a time, evicting the dTLB entries of the dtoa tables. Measures
+// dtoa throughput as the number of pages touched between conversions grows.
+// Methods with relocatable tables (see table-placement.h) are run twice:
+// with the tables in .rodata and with them copied into a 2MB huge page.
+//
+// Usage: ./tlb-pressure [method] [rounds]
+//   taskset -c 18 ./tlb-pressure
+
+#include "table-placement.h"
+#include "tool-methods.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Competitor: 64MB of 4K pages, far more than any dTLB covers.
+static constexpr size_t PAGE_SIZE = 4096;
+static constexpr int MAX_COMPETITOR_PAGES = 16384;
+static volatile uint64_t* competitor;
+
+static bool init_competitor() {
+  size_t size = MAX_COMPETITOR_PAGES * PAGE_SIZE;
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) return false;
+#ifdef MADV_NOHUGEPAGE
+  // Keep the competitor on 4K pages so each page costs a dTLB entry.
+  madvise(p, size, MADV_NOHUGEPAGE);
+#endif
+  competitor = static_cast<volatile uint64_t*>(p);
+  for (size_t i = 0; i < size / sizeof(uint64_t); i += PAGE_SIZE / sizeof(uint64_t))
+    competitor[i] = i * 0x9e3779b97f4a7c15ULL;
+  return true;
+}
+
+// Touch one cache line in each of N pages. The line offset within the page
+// rotates so that the walk doesn't also hammer a single cache set.
+static void __attribute__((noinline))
+touch_competitor(int num_pages) {
+  uint64_t sum = 0;
+  for (int i = 0; i < num_pages; i++) {
+    size_t index = (i * PAGE_SIZE + (i % 64) * 64) / sizeof(uint64_t);
+    sum += competitor[index];
+    competitor[index] = sum;
+  }
+}
+
+// Returns nanoseconds per dtoa call with `pages` competitor pages touched
+// between batches of conversions.
+static double __attribute__((noinline))
+measure_tlb(dtoa_fun dtoa, int pages, int rounds) {
+  char buffer[256];
+  constexpr int CALLS_PER_ROUND = 16;
+
+  for (int w = 0; w < 3; w++) {
+    touch_competitor(pages);
+    for (int i = 0; i < CALLS_PER_ROUND; i++) dtoa(test_values[i], buffer);
+  }
+
+  // Only the conversion batches are timed: the competitor walk is orders of
+  // magnitude longer, so subtracting it would drown the difference. The cost
+  // of timing each batch is subtracted as in cache-contention.
+  int next = 0;
+  std::chrono::steady_clock::duration total{};
+  for (int r = 0; r < rounds; r++) {
+    touch_competitor(pages);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALLS_PER_ROUND; i++) {
+      dtoa(test_values[next], buffer);
+      next = next + 1 < NUM_TEST_VALUES ? next + 1 : 0;
+    }
+    total += std::chrono::steady_clock::now() - start;
+  }
+  double total_ns = std::chrono::duration<double, std::nano>(total).count() -
+                    rounds * timer_overhead_ns();
+  return std::max(total_ns, 0.0) / (rounds * CALLS_PER_ROUND);
+}
+
+int main(int argc, char** argv) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  int rounds = argc > 2 ? atoi(argv[2]) : 2000;
+
+  if (!init_competitor()) {
+    fprintf(stderr, "error: cannot map the competitor buffer\n");
+    return 1;
+  }
+  init_test_values();
+
+  std::sort(methods.begin(), methods.end(),
+            [](const method& a, const method& b) { return a.name < b.name; });
+
+  const char* huge_page_kind = place_tables(table_placement::huge_page);
+  place_tables(table_placement::rodata);
+
+  std::vector<int> pressures = {0, 16, 64, 256, 1024, 4096, MAX_COMPETITOR_PAGES};
+
+  int name_width = 6;
+  for (const auto& m : methods) {
+    int len = static_cast<int>(m.name.size()) + 12;  // " (huge page)"
+    if (len > name_width) name_width = len;
+  }
+  name_width += 2;
+
+  printf("dTLB pressure test (%d dtoa calls between competitor walks)\n", 16);
+  printf("Competitor = one line in each of N 4K pages\n");
+  printf("Huge page for relocatable tables: %s\n\n", huge_page_kind);
+
+  printf("%-*s", name_width, "Method");
+  for (int pages : pressures) {
+    char hdr[16];
+    snprintf(hdr, sizeof(hdr), "%dp", pages);
+    printf(" %7s", hdr);
+  }
+  printf("  %7s\n", "slowdown");
+  printf("%-*s", name_width, "------");
+  for (size_t i = 0; i < pressures.size(); i++) printf(" %7s", "-------");
+  printf("  %7s\n", "-------");
+
+  for (const auto& m : methods) {
+    if (m.name == "null" || m.name == "ostringstream" || m.name == "sprintf")
+      continue;
+    if (filter && m.name != filter) continue;
+
+    bool relocatable = has_relocatable_tables(m.name.c_str());
+    for (auto placement : {table_placement::rodata, table_placement::huge_page}) {
+      if (placement == table_placement::huge_page && !relocatable) break;
+      place_tables(placement);
+
+      std::string label = m.name;
+      if (relocatable)
+        label += placement == table_placement::rodata ? " (rodata)" : " (huge page)";
+      printf("%-*s", name_width, label.c_str());
+      fflush(stdout);
+
+      double baseline = 0, worst = 0;
+      for (size_t i = 0; i < pressures.size(); i++) {
+        double ns = measure_tlb(m.dtoa, pressures[i], rounds);
+        for (int retry = 0; retry < 2; retry++)
+          ns = std::min(ns, measure_tlb(m.dtoa, pressures[i], rounds));
+        if (i == 0) baseline = ns;
+        worst = std::max(worst, ns);
+        printf(" %5.1fns", ns);
+        fflush(stdout);
+      }
+      printf("  %5.0f%%\n", (worst / baseline - 1.0) * 100.0);
+    }
+  }
+  place_tables(table_placement::rodata);
+
+  printf("\nTime = ns per dtoa call (batch timed without the competitor walk)\n");
+  printf("Slowdown = worst case vs no-pressure baseline\n");
+  return 0;
+}
@@ -4,4 +4,4 @@
 
 static register_method _("to_chars", [](double value, char* buffer) {
   return std::to_chars(buffer, buffer + 24, value).ptr;
-});
+}, nullptr, 24);
@@ -0,0 +1,55 @@
+#include "tool-methods.h"
+
+#include <math.h>    // isnan, isinf
+#include <stdint.h>  // uint64_t
+#include <stdio.h>   // snprintf
+#include <stdlib.h>  // strtod
+#include <string.h>  // memcpy
+
+#include <chrono>
+
+std::vector<method> methods;
+
+register_method::register_method(const char* name, dtoa_fun dtoa,
+                                 const char*, int max_write, dtoa_length_fun,
+                                 dtoa_loop_fun) {
+  methods.push_back(method{name, dtoa, max_write});
+}
+
+double test_values[NUM_TEST_VALUES];
+
+void init_test_values() {
+  unsigned seed = 42;
+  int idx = 0;
+  for (int digit = 1; digit <= MAX_DIGITS; digit++) {
+    for (int j = 0; j < VALUES_PER_DIGIT; j++) {
+      double d;
+      do {
+        uint64_t bits = 0;
+        seed = 214013 * seed + 2531011;
+        bits = uint64_t(seed) << 32;
+        seed = 214013 * seed + 2531011;
+        bits |= seed;
+        memcpy(&d, &bits, sizeof(d));
+      } while (isnan(d) || isinf(d));
+      // Reduce to the desired number of significant digits.
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.*g", digit, d);
+      test_values[idx++] = strtod(buf, nullptr);
+    }
+  }
+}
+
+auto timer_overhead_ns() -> double {
+  static const double overhead = [] {
+    constexpr int num_regions = 100'000;
+    std::chrono::steady_clock::duration total{};
+    for (int i = 0; i < num_regions; i++) {
+      auto start = std::chrono::steady_clock::now();
+      total += std::chrono::steady_clock::now() - start;
+    }
+    return std::chrono::duration<double, std::nano>(total).count() /
+           num_regions;
+  }();
+  return overhead;
+}
@@ -0,0 +1,39 @@
+// Method registry and test data shared by the standalone tools
+// (cache-contention, tlb-pressure, numa-benchmark, smt-interference,
+// dtoa-export and column-scaling), which link the dtoa methods without
+// benchmark.cc. tool-methods.cc defines register_method to collect them here.
+
+#ifndef TOOL_METHODS_H_
+#define TOOL_METHODS_H_
+
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+struct method {
+  std::string name;
+  dtoa_fun dtoa;
+  int max_write = 0;  // Declared bound on bytes written, 0 if none.
+};
+
+// Every registered method, in registration order.
+extern std::vector<method> methods;
+
+// Test data: uniform distribution across 1-17 significant digits.
+// 4 values per digit count = 68 values. This avoids the bias toward
+// 17-digit outputs that raw random bit patterns produce.
+constexpr int MAX_DIGITS = 17;
+constexpr int VALUES_PER_DIGIT = 4;
+constexpr int NUM_TEST_VALUES = MAX_DIGITS * VALUES_PER_DIGIT;
+extern double test_values[NUM_TEST_VALUES];
+
+// Fills test_values from a fixed seed, so all tools use the same values.
+void init_test_values();
+
+// Returns the cost in nanoseconds of an empty region timed with a pair of
+// steady_clock::now() calls, measured on the first call. Tools that time
+// short batches subtract it from each batch.
+auto timer_overhead_ns() -> double;
+
+#endif  // TOOL_METHODS_H_
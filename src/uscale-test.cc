@@ -12,4 +12,4 @@
 static register_method _("uscale", [](double value, char* buffer) -> char* {
   uscale_short(value, buffer);
   return buffer + strlen(buffer);
-});
+}, nullptr, 25);
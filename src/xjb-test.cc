@@ -1,6 +1,7 @@
 #include "benchmark.h"
 #include "xjb/xjb64.h"
 
+// xjb64 writes digits with 16-byte stores past the end of the output.
 static register_method _("xjb64", [](double x, char* buffer) -> char* {
   return xjb64(x, buffer);
-});
+}, nullptr, 32);
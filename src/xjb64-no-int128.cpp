@@ -0,0 +1,17 @@
+// xjb64 compiled a second time with umul128_hi64_fallback and
+// umul128_hi64_lo64_fallback in place of unsigned __int128 products, the
+// path taken on targets without it. xjb64 also uses __int128 directly in its
+// x86-64 digit generation, so u128 is still declared and only the
+// multiplication helpers see __SIZEOF_INT128__ undefined. The vendored
+// sources are used unmodified; the entry points are renamed to
+// xjb64_no_int128 and xjb32_no_int128.
+
+#include <stdint.h>
+
+#ifdef __SIZEOF_INT128__
+typedef __uint128_t u128;
+#  undef __SIZEOF_INT128__
+#  define xjb64 xjb64_no_int128
+#  define xjb32 xjb32_no_int128
+#  include "xjb/xjb64.cpp"
+#endif
@@ -0,0 +1,43 @@
+// Integer writers built from yy_double's static digit kernels,
+// write_u32_len_1_to_8 and write_u32_len_8, which are the ones yyjson uses for
+// integers. The vendored source is included unmodified with its entry points
+// renamed to yy_itoa_*, so that the kernels are inlined here.
+
+#define yy_double_to_string yy_itoa_double_to_string
+#define yy_string_to_double yy_itoa_string_to_double
+#include "yy/yy_double.c"
+
+char *yy_u32_to_string(uint32_t val, char *buf) {
+    u32 hgh;
+    if (val < 100000000) return (char *)write_u32_len_1_to_8(val, (u8 *)buf);
+    hgh = val / 100000000; /* 1-2 digits */
+    buf = (char *)write_u32_len_1_to_8(hgh, (u8 *)buf);
+    return (char *)write_u32_len_8(val - hgh * 100000000, (u8 *)buf);
+}
+
+char *yy_u64_to_string(uint64_t val, char *buf) {
+    u64 hgh;
+    u32 mid, low;
+    if (val < 100000000) { /* 1-8 digits */
+        return (char *)write_u32_len_1_to_8((u32)val, (u8 *)buf);
+    } else if (val < (u64)100000000 * 100000000) { /* 9-16 digits */
+        return (char *)write_u64_len_1_to_16(val, (u8 *)buf);
+    } else { /* 17-20 digits */
+        hgh = val / 100000000;
+        low = (u32)(val - hgh * 100000000); /* (val % 100000000) */
+        mid = (u32)(hgh % 100000000);
+        hgh = hgh / 100000000; /* 1-4 digits */
+        buf = (char *)write_u32_len_1_to_8((u32)hgh, (u8 *)buf);
+        buf = (char *)write_u32_len_8(mid, (u8 *)buf);
+        return (char *)write_u32_len_8(low, (u8 *)buf);
+    }
+}
+
+char *yy_i64_to_string(int64_t val, char *buf) {
+    u64 abs = (u64)val;
+    if (val < 0) {
+        *buf++ = '-';
+        abs = (u64)0 - abs;
+    }
+    return yy_u64_to_string(abs, buf);
+}
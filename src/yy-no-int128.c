@@ -0,0 +1,9 @@
+// yy_double compiled a second time with YY_HAS_INT128=0, so that u128_mul
+// and u128_mul_add use the portable 32-bit product fallback. The vendored
+// sources are used unmodified; the entry points are renamed to
+// yy_no_int128_*.
+
+#define YY_HAS_INT128 0
+#define yy_double_to_string yy_no_int128_double_to_string
+#define yy_string_to_double yy_no_int128_string_to_double
+#include "yy/yy_double.c"
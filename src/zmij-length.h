@@ -0,0 +1,29 @@
+// Output length of zmij::write, computed from zmij::to_decimal without
+// generating digits. zmij uses fmt's format, so the length is fmt's.
+
+#ifndef ZMIJ_LENGTH_H_
+#define ZMIJ_LENGTH_H_
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint64_t
+
+#include "dtoa-length.h"
+#include "zmij/zmij.h"
+
+inline auto zmij_length(double value) noexcept -> size_t {
+  auto dec = zmij::to_decimal(value);
+  if (dec.exp == zmij::non_finite_exp) return dec.negative + 3;  // nan or inf
+  if (dec.sig == 0) return dec.negative + 1;
+  // to_decimal keeps the trailing zeros that write drops.
+  uint64_t sig = uint64_t(dec.sig);
+  int exp = dec.exp;
+  while (sig % 10 == 0) {
+    sig /= 10;
+    ++exp;
+  }
+  int num_digits = dtoa_length::count_digits(sig);
+  return dtoa_length::fmt_length(dec.negative, num_digits,
+                                 exp + num_digits - 1);
+}
+
+#endif  // ZMIJ_LENGTH_H_
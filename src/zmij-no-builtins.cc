@@ -0,0 +1,9 @@
+// zmij compiled a second time with ZMIJ_NO_BUILTINS, so that leading and
+// trailing zero counts and byte swaps use the portable fallbacks instead of
+// __builtin_clzll, __builtin_ctzll and __builtin_bswap64, as with compilers
+// that lack them. The vendored sources are used unmodified; the namespace is
+// renamed to zmij_no_builtins.
+
+#define ZMIJ_NO_BUILTINS
+#define zmij zmij_no_builtins
+#include "zmij/zmij.cc"
@@ -0,0 +1,9 @@
+// zmij compiled a second time with ZMIJ_USE_INT128=0, the path taken on
+// targets without unsigned __int128 such as i386 and 32-bit ARM: 64x64-bit
+// products are assembled from four 32x32-bit ones and division by 10 is a
+// plain division. The vendored sources are used unmodified; the namespace
+// is renamed to zmij_no_int128.
+
+#define ZMIJ_USE_INT128 0
+#define zmij zmij_no_int128
+#include "zmij/zmij.cc"
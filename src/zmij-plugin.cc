@@ -0,0 +1,32 @@
+// Example plug-in exporting the vendored zmij, see dtoa-plugin.h.
+//
+// CMake builds it twice: zmij-plugin with default symbol visibility, so that
+// the calls from the wrappers below into zmij.cc go through the PLT as in a
+// typical out-of-tree build, and zmij-plugin-hidden with hidden visibility,
+// where they are direct. Both are verified against the in-tree zmij, and
+// their times relative to it give the cost of the PLT and of calling into
+// position-independent code.
+
+#include "dtoa-plugin.h"
+#include "zmij-length.h"
+#include "zmij/zmij.h"
+
+namespace {
+
+auto zmij_dtoa(double value, char* buffer) -> char* {
+  return zmij::write(buffer, zmij::double_buffer_size, value);
+}
+
+const dtoa_plugin_method methods[] = {
+    {"zmij", zmij_dtoa, "zmij", zmij::double_buffer_size, zmij_length},
+};
+
+const dtoa_plugin plugin = {DTOA_PLUGIN_VERSION,
+                            int(sizeof(methods) / sizeof(methods[0])),
+                            methods};
+
+}  // namespace
+
+DTOA_PLUGIN_EXPORT auto dtoa_plugin_get() -> const dtoa_plugin* {
+  return &plugin;
+}
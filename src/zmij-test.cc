@@ -1,7 +1,8 @@
 #include "zmij/zmij.h"
 
 #include "benchmark.h"
+#include "zmij-length.h"
 
-static register_method _("zmij", [](double x, char* buffer) noexcept {
+static register_method_inline _("zmij", [](double x, char* buffer) noexcept {
   return zmij::write(buffer, zmij::double_buffer_size, x);
-});
+}, nullptr, zmij::double_buffer_size, zmij_length);